@@ -1,8 +1,150 @@
 #include "shell.h"
 #include "vios.h"
+#include "string.h"
+
+static int shell_row = 0;
+
+static void shell_print_line(const char *line, int r, int g, int b)
+{
+    vios_print(line, 0, shell_row * SHELL_LINE_HEIGHT, r, g, b, 1);
+}
+
+static void shell_next_row()
+{
+    shell_row = (shell_row + 1) % SHELL_MAX_ROWS;
+}
+
+static void shell_readline(char *out, int max)
+{
+    char line[SHELL_MAX_LINE + 3] = "> ";
+    int len = 0;
+    out[0] = 0;
+
+    while (1)
+    {
+        int key = vios_getkeyblock();
+        if (key == '\n' || key == '\r')
+        {
+            break;
+        }
+
+        if (key == '\b')
+        {
+            if (len > 0)
+            {
+                out[--len] = 0;
+            }
+        }
+        else if (len < max - 1)
+        {
+            out[len++] = (char)key;
+            out[len] = 0;
+        }
+
+        strcpy(line + 2, out);
+        shell_print_line(line, 255, 255, 255);
+    }
+
+    shell_next_row();
+}
+
+static void shell_free_arguments(struct command_argument *arguments)
+{
+    while (arguments)
+    {
+        struct command_argument *next = arguments->next;
+        vios_free(arguments);
+        arguments = next;
+    }
+}
+
+static void shell_run_single(char *command)
+{
+    struct command_argument *arguments = vios_parse_command(command, SHELL_MAX_LINE);
+    if (!arguments)
+    {
+        return;
+    }
+
+    int pid = vios_spawn(arguments, -1, -1);
+    shell_free_arguments(arguments);
+    if (pid < 0)
+    {
+        shell_print_line("Could not start program", 255, 0, 0);
+        shell_next_row();
+        return;
+    }
+
+    vios_wait(pid);
+}
+
+// "a | b": a's stdout feeds b's stdin, both run together and the shell waits for both
+static void shell_run_pipeline(char *left, char *right)
+{
+    struct command_argument *writer = vios_parse_command(left, SHELL_MAX_LINE);
+    struct command_argument *reader = vios_parse_command(right, SHELL_MAX_LINE);
+    int fds[2];
+    int writer_pid = -1;
+    int reader_pid = -1;
+
+    if (!writer || !reader || vios_pipe(fds) < 0)
+    {
+        shell_print_line("Invalid pipeline", 255, 0, 0);
+        shell_next_row();
+        goto out;
+    }
+
+    reader_pid = vios_spawn(reader, fds[0], -1);
+    writer_pid = vios_spawn(writer, -1, fds[1]);
+
+    // The children hold their own references, closing ours lets the reader see end of file
+    vios_fd_close(fds[0]);
+    vios_fd_close(fds[1]);
+
+    if (writer_pid < 0 || reader_pid < 0)
+    {
+        shell_print_line("Could not start pipeline", 255, 0, 0);
+        shell_next_row();
+    }
+
+    if (writer_pid >= 0)
+    {
+        vios_wait(writer_pid);
+    }
+
+    if (reader_pid >= 0)
+    {
+        vios_wait(reader_pid);
+    }
+
+out:
+    shell_free_arguments(writer);
+    shell_free_arguments(reader);
+}
 
 int main(int argc, char **argv)
 {
-    vios_print("Test!", 0, 0, 255, 0, 0, 2);
+    char command[SHELL_MAX_LINE];
+    while (1)
+    {
+        shell_print_line("> ", 255, 255, 255);
+        shell_readline(command, sizeof(command));
+        if (command[0] == 0)
+        {
+            continue;
+        }
+
+        char *bar = strchr(command, '|');
+        if (bar)
+        {
+            *bar = 0;
+            shell_run_pipeline(command, bar + 1);
+        }
+        else
+        {
+            shell_run_single(command);
+        }
+    }
+
     return 0;
 }
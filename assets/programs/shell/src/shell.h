@@ -1,4 +1,8 @@
 #ifndef SHELL_H
 #define SHELL_H
 
-#endif
\ No newline at end of file
+#define SHELL_MAX_LINE 256
+#define SHELL_LINE_HEIGHT 10
+#define SHELL_MAX_ROWS 40
+
+#endif
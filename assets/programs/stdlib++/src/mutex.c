@@ -0,0 +1,78 @@
+#include "mutex.h"
+#include "vios.h"
+
+#define VIOS_MUTEX_UNLOCKED 0
+#define VIOS_MUTEX_LOCKED 1
+#define VIOS_MUTEX_CONTENDED 2
+
+#define VIOS_WAKE_ALL 0x7fffffff
+
+void vios_mutex_init(vios_mutex_t *mutex)
+{
+    mutex->state = VIOS_MUTEX_UNLOCKED;
+}
+
+// Slow path, marks the mutex contended so the holder knows to wake us on unlock
+static void vios_mutex_lock_contended(vios_mutex_t *mutex)
+{
+    while (__atomic_exchange_n(&mutex->state, VIOS_MUTEX_CONTENDED, __ATOMIC_ACQUIRE) != VIOS_MUTEX_UNLOCKED)
+    {
+        vios_futex_wait(&mutex->state, VIOS_MUTEX_CONTENDED);
+    }
+}
+
+void vios_mutex_lock(vios_mutex_t *mutex)
+{
+    // Uncontended case never enters the kernel
+    int expected = VIOS_MUTEX_UNLOCKED;
+    if (__atomic_compare_exchange_n(&mutex->state, &expected, VIOS_MUTEX_LOCKED, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    vios_mutex_lock_contended(mutex);
+}
+
+int vios_mutex_trylock(vios_mutex_t *mutex)
+{
+    int expected = VIOS_MUTEX_UNLOCKED;
+    return __atomic_compare_exchange_n(&mutex->state, &expected, VIOS_MUTEX_LOCKED, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? 0 : -1;
+}
+
+void vios_mutex_unlock(vios_mutex_t *mutex)
+{
+    // Only a mutex that had waiters needs a syscall to release
+    if (__atomic_exchange_n(&mutex->state, VIOS_MUTEX_UNLOCKED, __ATOMIC_RELEASE) == VIOS_MUTEX_CONTENDED)
+    {
+        vios_futex_wake(&mutex->state, 1);
+    }
+}
+
+void vios_cond_init(vios_cond_t *cond)
+{
+    cond->seq = 0;
+}
+
+void vios_cond_wait(vios_cond_t *cond, vios_mutex_t *mutex)
+{
+    int seq = __atomic_load_n(&cond->seq, __ATOMIC_RELAXED);
+    vios_mutex_unlock(mutex);
+
+    // Returns straight away if a signal already bumped seq
+    vios_futex_wait(&cond->seq, seq);
+
+    // Other waiters may have been woken with us, keep the mutex marked contended
+    vios_mutex_lock_contended(mutex);
+}
+
+void vios_cond_signal(vios_cond_t *cond)
+{
+    __atomic_fetch_add(&cond->seq, 1, __ATOMIC_RELEASE);
+    vios_futex_wake(&cond->seq, 1);
+}
+
+void vios_cond_broadcast(vios_cond_t *cond)
+{
+    __atomic_fetch_add(&cond->seq, 1, __ATOMIC_RELEASE);
+    vios_futex_wake(&cond->seq, VIOS_WAKE_ALL);
+}
@@ -0,0 +1,41 @@
+#ifndef VIOS_MUTEX_H
+#define VIOS_MUTEX_H
+
+// There is no thread API, so these synchronise separate processes that share the
+// lock through a shared memory region (vios_shm_create / vios_shm_map).
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // state: 0 = unlocked, 1 = locked, 2 = locked and possibly contended
+    typedef struct
+    {
+        volatile int state;
+    } vios_mutex_t;
+
+    // seq is bumped on every signal so waiters can tell a wakeup from a stale value
+    typedef struct
+    {
+        volatile int seq;
+    } vios_cond_t;
+
+#define VIOS_MUTEX_INITIALIZER {0}
+#define VIOS_COND_INITIALIZER {0}
+
+    void vios_mutex_init(vios_mutex_t *mutex);
+    void vios_mutex_lock(vios_mutex_t *mutex);
+    int vios_mutex_trylock(vios_mutex_t *mutex);
+    void vios_mutex_unlock(vios_mutex_t *mutex);
+
+    void vios_cond_init(vios_cond_t *cond);
+    void vios_cond_wait(vios_cond_t *cond, vios_mutex_t *mutex);
+    void vios_cond_signal(vios_cond_t *cond);
+    void vios_cond_broadcast(vios_cond_t *cond);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+#include "clock.h"
+
+static const struct vios_vclock *vios_vclock_page(void)
+{
+    return (const struct vios_vclock *)VIOS_VCLOCK_ADDRESS;
+}
+
+static uint64_t vios_clock_rdtsc(void)
+{
+    uint64_t tsc;
+    asm volatile("rdtsc" : "=A"(tsc));
+    return tsc;
+}
+
+// Takes a consistent copy, retrying while the kernel is mid-update
+static void vios_clock_snapshot(struct vios_vclock *out)
+{
+    const struct vios_vclock *page = vios_vclock_page();
+    uint32_t seq;
+    do
+    {
+        seq = page->seq;
+        asm volatile("" : : : "memory");
+        out->flags = page->flags;
+        out->mult = page->mult;
+        out->shift = page->shift;
+        out->base_tsc = page->base_tsc;
+        out->coarse_ns = page->coarse_ns;
+        out->ticks = page->ticks;
+        out->tick_hz = page->tick_hz;
+        out->frame_count = page->frame_count;
+        asm volatile("" : : : "memory");
+    } while ((seq & 1) || seq != page->seq);
+}
+
+uint64_t vios_clock_ns(void)
+{
+    struct vios_vclock clock;
+    vios_clock_snapshot(&clock);
+    if (!(clock.flags & VIOS_VCLOCK_FLAG_TSC))
+    {
+        return clock.coarse_ns;
+    }
+
+    // Same split multiply as the kernel so the intermediate doesn't overflow
+    uint64_t delta = vios_clock_rdtsc() - clock.base_tsc;
+    uint64_t low = (uint64_t)(uint32_t)delta * clock.mult;
+    uint64_t high = (uint64_t)(uint32_t)(delta >> 32) * clock.mult;
+    return (low >> clock.shift) + (high << (32 - clock.shift));
+}
+
+uint32_t vios_clock_ticks(void)
+{
+    struct vios_vclock clock;
+    vios_clock_snapshot(&clock);
+    return clock.ticks;
+}
+
+uint32_t vios_clock_frames(void)
+{
+    struct vios_vclock clock;
+    vios_clock_snapshot(&clock);
+    return clock.frame_count;
+}
+
+void vios_clock_wait_until(uint64_t deadline_ns)
+{
+    while (vios_clock_ns() < deadline_ns)
+    {
+        asm volatile("pause");
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef VIOS_CLOCK_H
+#define VIOS_CLOCK_H
+
+#include "vios.h"
+
+// Kernel clock page mapped read-only into every process, see src/time/vclock.h
+#define VIOS_VCLOCK_ADDRESS 0x3F0000
+#define VIOS_VCLOCK_FLAG_TSC 0x01
+
+struct vios_vclock
+{
+    volatile uint32_t seq;
+    uint32_t flags;
+    uint32_t mult;
+    uint32_t shift;
+    uint64_t base_tsc;
+    uint64_t coarse_ns;
+    uint32_t ticks;
+    uint32_t tick_hz;
+    uint32_t frame_count;
+};
+
+// All of these read the shared page and never enter the kernel
+uint64_t vios_clock_ns(void);
+uint32_t vios_clock_ticks(void);
+uint32_t vios_clock_frames(void);
+
+// Spins until the monotonic clock reaches deadline_ns
+void vios_clock_wait_until(uint64_t deadline_ns);
+
+#endif
@@ -0,0 +1,58 @@
+#include "ring.h"
+#include "memory.h"
+
+struct vios_ring *vios_ring_create(void)
+{
+    struct vios_ring *ring = vios_malloc(sizeof(struct vios_ring));
+    if (!ring)
+    {
+        return 0;
+    }
+
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(45), "b"(ring) : "memory");
+    if (result < 0)
+    {
+        vios_free(ring);
+        return 0;
+    }
+
+    return ring;
+}
+
+struct vios_ring_sqe *vios_ring_get_sqe(struct vios_ring *ring)
+{
+    if (ring->sq_tail - ring->sq_head >= VIOS_RING_ENTRIES)
+    {
+        return 0;
+    }
+
+    struct vios_ring_sqe *sqe = &ring->sq[ring->sq_tail % VIOS_RING_ENTRIES];
+    memset(sqe, 0, sizeof(struct vios_ring_sqe));
+
+    // The kernel only looks at the queue inside vios_ring_enter, so the slot can be published now
+    ring->sq_tail++;
+    return sqe;
+}
+
+int vios_ring_enter(struct vios_ring *ring, int min_complete)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(46), "b"(ring->sq_tail - ring->sq_head), "c"(min_complete) : "memory");
+    return result;
+}
+
+struct vios_ring_cqe *vios_ring_peek_cqe(struct vios_ring *ring)
+{
+    if (ring->cq_head == ring->cq_tail)
+    {
+        return 0;
+    }
+
+    return &ring->cq[ring->cq_head % VIOS_RING_ENTRIES];
+}
+
+void vios_ring_cqe_seen(struct vios_ring *ring)
+{
+    ring->cq_head++;
+}
@@ -0,0 +1,51 @@
+#ifndef VIOS_RING_H
+#define VIOS_RING_H
+
+#include "vios.h"
+
+// Must match VIOS_SYSCALL_RING_ENTRIES and struct syscall_ring in the kernel
+#define VIOS_RING_ENTRIES 64
+#define VIOS_RING_MAX_ARGS 7
+
+// Completes after args[0] milliseconds, the submitter keeps running meanwhile
+#define VIOS_RING_OP_TIMEOUT 0xFFFF
+
+// args are the EBX, ECX, EDX, ESI, EDI registers of the call, or its stack arguments for
+// calls such as vios_print that take them on the stack
+struct vios_ring_sqe
+{
+    uint32_t command;
+    uint32_t args[VIOS_RING_MAX_ARGS];
+    uint32_t user_data;
+};
+
+struct vios_ring_cqe
+{
+    uint32_t user_data;
+    int result;
+};
+
+struct vios_ring
+{
+    volatile uint32_t sq_head;
+    volatile uint32_t sq_tail;
+    volatile uint32_t cq_head;
+    volatile uint32_t cq_tail;
+    struct vios_ring_sqe sq[VIOS_RING_ENTRIES];
+    struct vios_ring_cqe cq[VIOS_RING_ENTRIES];
+};
+
+// Allocates a ring and registers it with the kernel, one ring per process
+struct vios_ring *vios_ring_create(void);
+
+// Next free submission slot, zero when the submission queue is full
+struct vios_ring_sqe *vios_ring_get_sqe(struct vios_ring *ring);
+
+// Hands every queued entry to the kernel in one trap and waits for min_complete completions
+int vios_ring_enter(struct vios_ring *ring, int min_complete);
+
+// Oldest unread completion or zero, release it with vios_ring_cqe_seen
+struct vios_ring_cqe *vios_ring_peek_cqe(struct vios_ring *ring);
+void vios_ring_cqe_seen(struct vios_ring *ring);
+
+#endif
@@ -110,6 +110,226 @@ void vix_present_frame(void)
     asm volatile("int $0x80" : : "a"(15) : "memory");
 }
 
+uint16_t *vix_surface_create(int width, int height)
+{
+    void *result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(49), "b"(width), "c"(height) : "memory");
+    return (int)result < 0 ? 0 : result;
+}
+
+int vix_surface_present(int x, int y, const vix_rect_t *rect, int present)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(50), "b"(x), "c"(y), "d"(rect), "S"(present) : "memory");
+    return result;
+}
+
+int vix_window_create(int x, int y, int width, int height)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(52), "b"(x), "c"(y), "d"(width), "S"(height) : "memory");
+    return result;
+}
+
+// Operations match enum compositor_window_op in the kernel
+static int vix_window_control(int window, int op, int x, int y)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(53), "b"(window), "c"(op), "d"(x), "S"(y) : "memory");
+    return result;
+}
+
+int vix_window_destroy(int window)
+{
+    return vix_window_control(window, 0, 0, 0);
+}
+
+int vix_window_move(int window, int x, int y)
+{
+    return vix_window_control(window, 1, x, y);
+}
+
+int vix_window_raise(int window)
+{
+    return vix_window_control(window, 2, 0, 0);
+}
+
+int vix_window_select(int window)
+{
+    return vix_window_control(window, 3, 0, 0);
+}
+
+// Mirrors the records decoded in the kernel's src/isr80h/vix_graphics.c
+enum
+{
+    VIX_CMD_CLEAR = 1,
+    VIX_CMD_FILL_RECT,
+    VIX_CMD_DRAW_RECT,
+    VIX_CMD_DRAW_LINE,
+    VIX_CMD_DRAW_CIRCLE,
+    VIX_CMD_FILL_CIRCLE,
+    VIX_CMD_DRAW_TEXT,
+    VIX_CMD_BLIT,
+    VIX_CMD_PRESENT,
+};
+
+struct vix_cmd_header
+{
+    uint16_t op;
+    uint16_t size;
+};
+
+struct vix_cmd_clear
+{
+    struct vix_cmd_header header;
+    uint32_t color;
+};
+
+// Rectangles, lines and circles share one layout, unused fields stay zero
+struct vix_cmd_shape
+{
+    struct vix_cmd_header header;
+    int16_t a, b, c, d;
+    uint32_t color;
+};
+
+struct vix_cmd_text
+{
+    struct vix_cmd_header header;
+    int16_t x, y;
+    uint16_t scale;
+    uint16_t length;
+    uint32_t color;
+    char text[];
+};
+
+struct vix_cmd_blit
+{
+    struct vix_cmd_header header;
+    int16_t src_x, src_y;
+    int16_t width, height;
+    int16_t x, y;
+};
+
+// Room for a record of size bytes, rounded up to the four byte record alignment
+static void *vix_cmd_reserve(struct vix_cmdbuf *buf, uint16_t op, uint32_t size)
+{
+    size = (size + 3) & ~3;
+    if (size > VIX_CMDBUF_SIZE)
+    {
+        return 0;
+    }
+
+    if (buf->used + size > VIX_CMDBUF_SIZE)
+    {
+        vix_cmd_submit(buf);
+    }
+
+    struct vix_cmd_header *header = (struct vix_cmd_header *)((char *)buf->data + buf->used);
+    header->op = op;
+    header->size = size;
+    buf->used += size;
+    return header;
+}
+
+static void vix_cmd_shape(struct vix_cmdbuf *buf, uint16_t op, int a, int b, int c, int d, uint32_t color)
+{
+    struct vix_cmd_shape *cmd = vix_cmd_reserve(buf, op, sizeof(*cmd));
+    cmd->a = a;
+    cmd->b = b;
+    cmd->c = c;
+    cmd->d = d;
+    cmd->color = color;
+}
+
+void vix_cmd_clear(struct vix_cmdbuf *buf, uint32_t color)
+{
+    struct vix_cmd_clear *cmd = vix_cmd_reserve(buf, VIX_CMD_CLEAR, sizeof(*cmd));
+    cmd->color = color;
+}
+
+void vix_cmd_fill_rect(struct vix_cmdbuf *buf, int x, int y, int width, int height, uint32_t color)
+{
+    vix_cmd_shape(buf, VIX_CMD_FILL_RECT, x, y, width, height, color);
+}
+
+void vix_cmd_draw_rect(struct vix_cmdbuf *buf, int x, int y, int width, int height, uint32_t color)
+{
+    vix_cmd_shape(buf, VIX_CMD_DRAW_RECT, x, y, width, height, color);
+}
+
+void vix_cmd_draw_line(struct vix_cmdbuf *buf, int x1, int y1, int x2, int y2, uint32_t color)
+{
+    vix_cmd_shape(buf, VIX_CMD_DRAW_LINE, x1, y1, x2, y2, color);
+}
+
+void vix_cmd_draw_circle(struct vix_cmdbuf *buf, int x, int y, int radius, uint32_t color)
+{
+    vix_cmd_shape(buf, VIX_CMD_DRAW_CIRCLE, x, y, radius, 0, color);
+}
+
+void vix_cmd_fill_circle(struct vix_cmdbuf *buf, int x, int y, int radius, uint32_t color)
+{
+    vix_cmd_shape(buf, VIX_CMD_FILL_CIRCLE, x, y, radius, 0, color);
+}
+
+void vix_cmd_draw_text(struct vix_cmdbuf *buf, const char *text, int x, int y, uint32_t color, int scale)
+{
+    int length = strlen(text);
+    struct vix_cmd_text *cmd = vix_cmd_reserve(buf, VIX_CMD_DRAW_TEXT, sizeof(*cmd) + length + 1);
+    if (!cmd)
+    {
+        return;
+    }
+
+    cmd->x = x;
+    cmd->y = y;
+    cmd->scale = scale;
+    cmd->length = length;
+    cmd->color = color;
+
+    // Zero the padding along with the terminator
+    char *end = (char *)cmd + cmd->header.size;
+    char *out = cmd->text;
+    for (int i = 0; i < length; i++)
+    {
+        *out++ = text[i];
+    }
+    while (out < end)
+    {
+        *out++ = 0;
+    }
+}
+
+void vix_cmd_blit(struct vix_cmdbuf *buf, const vix_rect_t *rect, int x, int y)
+{
+    struct vix_cmd_blit *cmd = vix_cmd_reserve(buf, VIX_CMD_BLIT, sizeof(*cmd));
+    cmd->src_x = rect->x;
+    cmd->src_y = rect->y;
+    cmd->width = rect->width;
+    cmd->height = rect->height;
+    cmd->x = x;
+    cmd->y = y;
+}
+
+void vix_cmd_present(struct vix_cmdbuf *buf)
+{
+    vix_cmd_reserve(buf, VIX_CMD_PRESENT, sizeof(struct vix_cmd_header));
+}
+
+int vix_cmd_submit(struct vix_cmdbuf *buf)
+{
+    if (buf->used == 0)
+    {
+        return 0;
+    }
+
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(51), "b"(buf->data), "c"(buf->used) : "memory");
+    buf->used = 0;
+    return result;
+}
+
 void vix_get_screen_info(vix_screen_info_t *info)
 {
     asm volatile("int $0x80" : : "a"(16), "b"(info) : "memory");
@@ -179,3 +399,220 @@ void via_sound_stop(void)
 {
     asm volatile("int $0x80" : : "a"(27) : "memory");
 }
+
+// Futex - returns 0 when woken, negative if *addr no longer held expected
+int vios_futex_wait(volatile int *addr, int expected)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(28), "b"(addr), "c"(expected) : "memory");
+    return result;
+}
+
+int vios_futex_wake(volatile int *addr, int count)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(29), "b"(addr), "c"(count) : "memory");
+    return result;
+}
+
+uint64_t vios_time_ns(void)
+{
+    uint64_t result;
+    asm volatile("int $0x80" : "=A"(result) : "a"(30) : "memory");
+    return result;
+}
+
+// IPC - message words in ECX/EDX/EDI, payload in ESI
+int vios_ipc_port_create(void)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(31) : "memory");
+    return result;
+}
+
+int vios_ipc_port_destroy(int port)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(32), "b"(port) : "memory");
+    return result;
+}
+
+static int vios_ipc_call(int command, int target, struct vios_ipc_message *message)
+{
+    int result;
+    uint32_t w0 = message->words[0];
+    uint32_t w1 = message->words[1];
+    uint32_t w2 = message->words[2];
+    void *payload = message->payload;
+    asm volatile("int $0x80"
+                 : "=a"(result), "+c"(w0), "+d"(w1), "+D"(w2), "+S"(payload)
+                 : "0"(command), "b"(target)
+                 : "memory");
+    message->words[0] = w0;
+    message->words[1] = w1;
+    message->words[2] = w2;
+    message->payload = payload;
+    return result;
+}
+
+// Blocks until the receiver replies, the reply overwrites message
+int vios_ipc_send(int port, struct vios_ipc_message *message)
+{
+    return vios_ipc_call(33, port, message);
+}
+
+// Blocks until a message arrives, returns the sender id to reply to
+int vios_ipc_receive(int port, struct vios_ipc_message *message)
+{
+    message->words[0] = message->words[1] = message->words[2] = 0;
+    message->payload = 0;
+    return vios_ipc_call(34, port, message);
+}
+
+int vios_ipc_reply(int sender, struct vios_ipc_message *message)
+{
+    int result;
+    asm volatile("int $0x80"
+                 : "=a"(result)
+                 : "a"(35), "b"(sender), "c"(message->words[0]), "d"(message->words[1]), "D"(message->words[2]), "S"(message->payload)
+                 : "memory");
+    return result;
+}
+
+// Pipes and descriptors - fd 0 is stdin and fd 1 is stdout, vios_print/vios_getkey follow them
+int vios_pipe(int fds[2])
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(36), "b"(fds) : "memory");
+    return result;
+}
+
+int vios_fd_read(int fd, void *buf, int len)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(37), "b"(fd), "c"(buf), "d"(len) : "memory");
+    return result;
+}
+
+int vios_fd_write(int fd, const void *buf, int len)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(38), "b"(fd), "c"(buf), "d"(len) : "memory");
+    return result;
+}
+
+int vios_fd_close(int fd)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(39), "b"(fd) : "memory");
+    return result;
+}
+
+int vios_spawn(struct command_argument *arguments, int stdin_fd, int stdout_fd)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(40), "b"(arguments), "c"(stdin_fd), "d"(stdout_fd) : "memory");
+    return result;
+}
+
+int vios_wait(int pid)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(41), "b"(pid) : "memory");
+    return result;
+}
+
+// Shared memory - regions live until their last mapping goes away
+int vios_shm_create(unsigned int size, void *addr, void **mapped)
+{
+    int result;
+    void *out = addr;
+    asm volatile("int $0x80" : "=a"(result), "+c"(out) : "a"(42), "b"(size) : "memory");
+    if (result > 0 && mapped)
+    {
+        *mapped = out;
+    }
+    return result;
+}
+
+void *vios_shm_map(int id, void *addr)
+{
+    void *result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(43), "b"(id), "c"(addr) : "memory");
+    return (int)result < 0 ? 0 : result;
+}
+
+int vios_shm_unmap(void *addr)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(44), "b"(addr) : "memory");
+    return result;
+}
+
+int vios_batch(struct vios_batch_entry *entries, int count)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(47), "b"(entries), "c"(count) : "memory");
+    return result;
+}
+
+void vios_batch_add(struct vios_batch *batch, uint32_t command, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4)
+{
+    if (batch->count == VIOS_BATCH_MAX)
+    {
+        vios_batch_flush(batch);
+    }
+
+    struct vios_batch_entry *entry = &batch->entries[batch->count++];
+    entry->command = command;
+    entry->args[0] = a0;
+    entry->args[1] = a1;
+    entry->args[2] = a2;
+    entry->args[3] = a3;
+    entry->args[4] = a4;
+    entry->result = 0;
+}
+
+int vios_batch_flush(struct vios_batch *batch)
+{
+    if (batch->count == 0)
+    {
+        return 0;
+    }
+
+    int result = vios_batch(batch->entries, batch->count);
+    batch->count = 0;
+    return result;
+}
+
+void vix_batch_fill_rect(struct vios_batch *batch, int x, int y, int width, int height, uint32_t color)
+{
+    vios_batch_add(batch, 13, x, y, width, height, color);
+}
+
+void vix_batch_clear_screen(struct vios_batch *batch, uint32_t color)
+{
+    vios_batch_add(batch, 14, color, 0, 0, 0, 0);
+}
+
+void vix_batch_present_frame(struct vios_batch *batch)
+{
+    vios_batch_add(batch, 15, 0, 0, 0, 0, 0);
+}
+
+void vix_batch_draw_text(struct vios_batch *batch, const char *text, int x, int y, uint32_t color)
+{
+    vios_batch_add(batch, 20, (uint32_t)text, x, y, color, 0);
+}
+
+void vix_batch_draw_text_scaled(struct vios_batch *batch, const char *text, int x, int y, uint32_t color, int scale)
+{
+    vios_batch_add(batch, 21, (uint32_t)text, x, y, color, scale);
+}
+
+int vios_syscall_trace(int op, struct vios_syscall_stats *stats, int count)
+{
+    int result;
+    asm volatile("int $0x80" : "=a"(result) : "a"(48), "b"(op), "c"(stats), "d"(count) : "memory");
+    return result;
+}
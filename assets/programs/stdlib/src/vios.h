@@ -5,7 +5,10 @@
 #include <stdbool.h>
 
 // Define types manually since stdint.h is not available
+typedef short int16_t;
+typedef unsigned short uint16_t;
 typedef unsigned int uint32_t;
+typedef unsigned long long uint64_t;
 
 struct command_argument
 {
@@ -69,6 +72,51 @@ void vix_draw_text_scaled(const char *text, int x, int y, uint32_t color, int sc
 int vix_text_width(const char *text, int scale);
 int vix_text_height(int scale);
 
+// Drawing surface - RGB565 pixels mapped into the program, rows are width pixels apart.
+// Draw with plain stores, then one vix_surface_present copies it into the back buffer.
+typedef struct
+{
+    int x, y;
+    int width, height;
+} vix_rect_t;
+
+uint16_t *vix_surface_create(int width, int height);
+// rect may be 0 for the whole surface, present also shows the frame like vix_present_frame
+int vix_surface_present(int x, int y, const vix_rect_t *rect, int present);
+
+// Windows - composited, opaque and owned by the program. VIX drawing goes into the selected
+// window (a new one is selected) in window coordinates, and vix_present_frame repaints only
+// what changed. Selecting window 0 draws straight onto the screen again.
+int vix_window_create(int x, int y, int width, int height);
+int vix_window_destroy(int window);
+int vix_window_move(int window, int x, int y);
+int vix_window_raise(int window);
+int vix_window_select(int window);
+
+// Command buffer - VIX drawing recorded as compact records and run with one vix_cmd_submit.
+// Text is copied into the buffer, so it doesn't have to outlive the call. A full buffer is
+// submitted on its own, coordinates are 16 bit.
+#define VIX_CMDBUF_SIZE 16384
+
+struct vix_cmdbuf
+{
+    uint32_t used;
+    uint32_t data[VIX_CMDBUF_SIZE / 4];
+};
+
+void vix_cmd_clear(struct vix_cmdbuf *buf, uint32_t color);
+void vix_cmd_fill_rect(struct vix_cmdbuf *buf, int x, int y, int width, int height, uint32_t color);
+void vix_cmd_draw_rect(struct vix_cmdbuf *buf, int x, int y, int width, int height, uint32_t color);
+void vix_cmd_draw_line(struct vix_cmdbuf *buf, int x1, int y1, int x2, int y2, uint32_t color);
+void vix_cmd_draw_circle(struct vix_cmdbuf *buf, int x, int y, int radius, uint32_t color);
+void vix_cmd_fill_circle(struct vix_cmdbuf *buf, int x, int y, int radius, uint32_t color);
+void vix_cmd_draw_text(struct vix_cmdbuf *buf, const char *text, int x, int y, uint32_t color, int scale);
+// Copies rect of the surface from vix_surface_create to x, y
+void vix_cmd_blit(struct vix_cmdbuf *buf, const vix_rect_t *rect, int x, int y);
+void vix_cmd_present(struct vix_cmdbuf *buf);
+// Returns the number of records run, negative when the kernel rejected one
+int vix_cmd_submit(struct vix_cmdbuf *buf);
+
 // VIA (VIOS API) - Keyboard functions
 int via_keyboard_read(char *buffer, int buffer_size, int blocking);
 int via_keyboard_state(void);
@@ -77,4 +125,89 @@ int via_keyboard_state(void);
 void via_sound_play(uint32_t frequency, uint32_t duration);
 void via_sound_stop(void);
 
+// Futex wait/wake, addr must be 4-byte aligned
+int vios_futex_wait(volatile int *addr, int expected);
+int vios_futex_wake(volatile int *addr, int count);
+
+// Monotonic nanoseconds since boot
+uint64_t vios_time_ns(void);
+
+// IPC - small messages travel in registers, payload must be a whole vios_malloc allocation
+// and is moved (not copied) into the receiver's address space
+struct vios_ipc_message
+{
+    uint32_t words[3];
+    void *payload;
+};
+
+int vios_ipc_port_create(void);
+int vios_ipc_port_destroy(int port);
+int vios_ipc_send(int port, struct vios_ipc_message *message);
+int vios_ipc_receive(int port, struct vios_ipc_message *message);
+int vios_ipc_reply(int sender, struct vios_ipc_message *message);
+
+// Pipes - reads and writes move at most 512 bytes per call and block while the pipe is empty/full.
+// vios_fd_read returns 0 once every writer has closed.
+int vios_pipe(int fds[2]);
+int vios_fd_read(int fd, void *buf, int len);
+int vios_fd_write(int fd, const void *buf, int len);
+int vios_fd_close(int fd);
+
+// Starts a program without switching to it, -1 for either fd keeps the console. Returns the pid
+int vios_spawn(struct command_argument *arguments, int stdin_fd, int stdout_fd);
+int vios_wait(int pid);
+
+// Shared memory - the same pages mapped into every process that maps the region id.
+// addr may be 0 to let the kernel pick an address in the shared window (0x40000000 and up).
+int vios_shm_create(unsigned int size, void *addr, void **mapped);
+void *vios_shm_map(int id, void *addr);
+int vios_shm_unmap(void *addr);
+
+// Batch - runs up to VIOS_BATCH_MAX non-blocking calls (e.g. VIX drawing) with a single trap.
+// Each entry's result receives the call's return value.
+#define VIOS_BATCH_MAX 64
+
+struct vios_batch_entry
+{
+    uint32_t command;
+    uint32_t args[5];
+    int result;
+};
+
+struct vios_batch
+{
+    struct vios_batch_entry entries[VIOS_BATCH_MAX];
+    int count;
+};
+
+int vios_batch(struct vios_batch_entry *entries, int count);
+void vios_batch_add(struct vios_batch *batch, uint32_t command, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4);
+int vios_batch_flush(struct vios_batch *batch);
+
+// Queue VIX calls instead of trapping, text must stay valid until the flush
+void vix_batch_fill_rect(struct vios_batch *batch, int x, int y, int width, int height, uint32_t color);
+void vix_batch_clear_screen(struct vios_batch *batch, uint32_t color);
+void vix_batch_present_frame(struct vios_batch *batch);
+void vix_batch_draw_text(struct vios_batch *batch, const char *text, int x, int y, uint32_t color);
+void vix_batch_draw_text_scaled(struct vios_batch *batch, const char *text, int x, int y, uint32_t color, int scale);
+
+// Syscall tracing - per command call counts, TSC cycles and log2 latency histograms
+#define VIOS_TRACE_READ 0
+#define VIOS_TRACE_ENABLE 1
+#define VIOS_TRACE_DISABLE 2
+#define VIOS_TRACE_RESET 3
+#define VIOS_TRACE_BUCKETS 32
+
+struct vios_syscall_stats
+{
+    uint32_t command;
+    uint32_t calls;
+    uint64_t total_cycles;
+    uint64_t max_cycles;
+    uint32_t histogram[VIOS_TRACE_BUCKETS];
+};
+
+// For VIOS_TRACE_READ fills stats[i] for command i and returns the entries written
+int vios_syscall_trace(int op, struct vios_syscall_stats *stats, int count);
+
 #endif
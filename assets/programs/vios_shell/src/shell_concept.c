@@ -37,6 +37,13 @@ void shell_main() {
         // Get user input
         shell_get_input(command, sizeof(command));
         
+        // "a | b" runs both programs at once with a's output feeding b's input
+        if (strchr(command, '|')) {
+            shell_execute_pipeline(command);
+            current_line++;
+            continue;
+        }
+        
         // Parse command and arguments
         shell_parse_command(command, args);
         
@@ -84,6 +91,28 @@ void shell_execute_program(const char* program_name, const char* args) {
     }
 }
 
+void shell_execute_pipeline(char* line) {
+    char* bar = strchr(line, '|');
+    *bar = 0;
+    
+    struct command_argument* writer = vios_parse_command(line, 256);
+    struct command_argument* reader = vios_parse_command(bar + 1, 256);
+    int fds[2];
+    if (!writer || !reader || vios_pipe(fds) < 0) {
+        vios_print("Invalid pipeline", 10, current_line * 20, 255, 0, 0, 1);
+        return;
+    }
+    
+    // Each child gets its own end, the shell drops its copies so the reader sees end of file
+    int reader_pid = vios_spawn(reader, fds[0], -1);
+    int writer_pid = vios_spawn(writer, -1, fds[1]);
+    vios_fd_close(fds[0]);
+    vios_fd_close(fds[1]);
+    
+    if (writer_pid >= 0) vios_wait(writer_pid);
+    if (reader_pid >= 0) vios_wait(reader_pid);
+}
+
 void shell_show_help() {
     vios_print("Available commands:", 10, current_line * 20, 255, 255, 0, 1);
     current_line++;
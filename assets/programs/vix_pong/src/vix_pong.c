@@ -1,5 +1,6 @@
 #include "vios.h"
 #include "stdio.h"
+#include "clock.h"
 
 // Pong game constants
 #define SCREEN_WIDTH 1024
@@ -11,6 +12,7 @@
 #define BALL_SPEED_X 3
 #define BALL_SPEED_Y 2
 #define SCORE_TARGET 10
+#define FRAME_TIME_NS (1000000000ULL / 60)
 
 // Game state
 typedef struct {
@@ -142,67 +144,65 @@ void update_ball(void) {
     }
 }
 
+// Every draw call for a frame is recorded here and submitted to the kernel with one trap
+static struct vix_cmdbuf frame_commands;
+
 void draw_dashed_line(void) {
     // Draw center dashed line
     for (int y = 0; y < SCREEN_HEIGHT; y += 20) {
-        vix_fill_rect(SCREEN_WIDTH/2 - 2, y, 4, 10, VIX_COLOR_WHITE);
+        vix_cmd_fill_rect(&frame_commands, SCREEN_WIDTH/2 - 2, y, 4, 10, VIX_COLOR_WHITE);
+    }
+}
+
+static void format_score(char *text, int score) {
+    if (score < 10) {
+        text[0] = '0' + score;
+        text[1] = '\0';
+    } else {
+        text[0] = '1';
+        text[1] = '0' + (score - 10);
+        text[2] = '\0';
     }
 }
 
 void draw_pong_game(void) {
+    char score_text[4];
+
     // Clear screen
-    vix_clear_screen(VIX_COLOR_BLACK);
+    vix_cmd_clear(&frame_commands, VIX_COLOR_BLACK);
     
     // Draw center line
     draw_dashed_line();
     
     // Draw paddles
-    vix_fill_rect(30, game.paddle1_y, PADDLE_WIDTH, PADDLE_HEIGHT, VIX_COLOR_WHITE);
-    vix_fill_rect(SCREEN_WIDTH - 30 - PADDLE_WIDTH, game.paddle2_y, PADDLE_WIDTH, PADDLE_HEIGHT, VIX_COLOR_WHITE);
+    vix_cmd_fill_rect(&frame_commands, 30, game.paddle1_y, PADDLE_WIDTH, PADDLE_HEIGHT, VIX_COLOR_WHITE);
+    vix_cmd_fill_rect(&frame_commands, SCREEN_WIDTH - 30 - PADDLE_WIDTH, game.paddle2_y, PADDLE_WIDTH, PADDLE_HEIGHT, VIX_COLOR_WHITE);
     
     // Draw ball
-    vix_fill_rect(game.ball_x, game.ball_y, BALL_SIZE, BALL_SIZE, VIX_COLOR_WHITE);
+    vix_cmd_fill_rect(&frame_commands, game.ball_x, game.ball_y, BALL_SIZE, BALL_SIZE, VIX_COLOR_WHITE);
     
     // Draw scores
-    char score_text[32];
-    // Player 1 score
-    if (game.score1 < 10) {
-        score_text[0] = '0' + game.score1;
-        score_text[1] = '\0';
-    } else {
-        score_text[0] = '1';
-        score_text[1] = '0' + (game.score1 - 10);
-        score_text[2] = '\0';
-    }
-    vix_draw_text_scaled(score_text, SCREEN_WIDTH/2 - 100, 50, VIX_COLOR_WHITE, 4);
-    
-    // Player 2 score
-    if (game.score2 < 10) {
-        score_text[0] = '0' + game.score2;
-        score_text[1] = '\0';
-    } else {
-        score_text[0] = '1';
-        score_text[1] = '0' + (game.score2 - 10);
-        score_text[2] = '\0';
-    }
-    vix_draw_text_scaled(score_text, SCREEN_WIDTH/2 + 50, 50, VIX_COLOR_WHITE, 4);
+    format_score(score_text, game.score1);
+    vix_cmd_draw_text(&frame_commands, score_text, SCREEN_WIDTH/2 - 100, 50, VIX_COLOR_WHITE, 4);
+    format_score(score_text, game.score2);
+    vix_cmd_draw_text(&frame_commands, score_text, SCREEN_WIDTH/2 + 50, 50, VIX_COLOR_WHITE, 4);
     
     // Draw title
-    vix_draw_text_scaled("VIX PONG DEMO", SCREEN_WIDTH/2 - 160, 10, VIX_COLOR_CYAN, 2);
+    vix_cmd_draw_text(&frame_commands, "VIX PONG DEMO", SCREEN_WIDTH/2 - 160, 10, VIX_COLOR_CYAN, 2);
     
     // Draw game over message
     if (game.game_over) {
         if (game.winner == 1) {
-            vix_draw_text_scaled("LEFT PLAYER WINS!", SCREEN_WIDTH/2 - 200, SCREEN_HEIGHT/2, VIX_COLOR_GREEN, 3);
+            vix_cmd_draw_text(&frame_commands, "LEFT PLAYER WINS!", SCREEN_WIDTH/2 - 200, SCREEN_HEIGHT/2, VIX_COLOR_GREEN, 3);
         } else {
-            vix_draw_text_scaled("RIGHT PLAYER WINS!", SCREEN_WIDTH/2 - 210, SCREEN_HEIGHT/2, VIX_COLOR_GREEN, 3);
+            vix_cmd_draw_text(&frame_commands, "RIGHT PLAYER WINS!", SCREEN_WIDTH/2 - 210, SCREEN_HEIGHT/2, VIX_COLOR_GREEN, 3);
         }
-        vix_draw_text_scaled("Game will restart in 3 seconds...", SCREEN_WIDTH/2 - 300, SCREEN_HEIGHT/2 + 60, VIX_COLOR_YELLOW, 2);
+        vix_cmd_draw_text(&frame_commands, "Game will restart in 3 seconds...", SCREEN_WIDTH/2 - 300, SCREEN_HEIGHT/2 + 60, VIX_COLOR_YELLOW, 2);
     }
     
     // Draw instructions
-    vix_draw_text("Auto-playing AI vs AI Pong - First to 10 wins!", 50, SCREEN_HEIGHT - 40, VIX_COLOR_YELLOW);
-    vix_draw_text("VIX Graphics System Demo", 50, SCREEN_HEIGHT - 20, VIX_RGB(150, 150, 150));
+    vix_cmd_draw_text(&frame_commands, "Auto-playing AI vs AI Pong - First to 10 wins!", 50, SCREEN_HEIGHT - 40, VIX_COLOR_YELLOW, 1);
+    vix_cmd_draw_text(&frame_commands, "VIX Graphics System Demo", 50, SCREEN_HEIGHT - 20, VIX_RGB(150, 150, 150), 1);
 }
 
 int main(int argc, char** argv) {
@@ -212,6 +212,7 @@ int main(int argc, char** argv) {
     init_pong_game();
     
     int restart_timer = 0;
+    uint64_t next_frame_ns = vios_clock_ns();
     
     while (1) {
         // Update game logic
@@ -230,11 +231,18 @@ int main(int argc, char** argv) {
         // Draw everything
         draw_pong_game();
         
-        // Present frame
-        vix_present_frame();
+        // Present frame, one trap for the whole frame
+        vix_cmd_present(&frame_commands);
+        vix_cmd_submit(&frame_commands);
         
-        // Simple frame delay (rough 60 FPS)
-        for (volatile int i = 0; i < 100000; i++);
+        // Pace to 60 FPS off the shared clock page, no syscalls needed
+        next_frame_ns += FRAME_TIME_NS;
+        uint64_t now_ns = vios_clock_ns();
+        if (next_frame_ns < now_ns) {
+            // Fell behind, don't try to catch up with a burst of frames
+            next_frame_ns = now_ns;
+        }
+        vios_clock_wait_until(next_frame_ns);
         
         game.frame_count++;
         
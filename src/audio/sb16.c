@@ -6,8 +6,10 @@
 #include "string/string.h"
 #include "status.h"
 #include "math/fpu_math.h"
+#include "task/fpu.h"
 #include "rtc/rtc.h"
 #include "idt/idt.h"
+#include "irq/irq.h"
 #include "task/process.h"
 #include "task/task.h"
 #include "config.h"
@@ -64,23 +66,13 @@ static void sleep_us(int us)
 // Enable IRQ 5 for Sound Blaster
 static void sb16_enable_irq(void)
 {
-    // Read current mask from master PIC
-    uint8_t mask = inb(0x21);
-    // Clear bit 5 to enable IRQ 5
-    mask &= ~(1 << 5);
-    // Write back the mask
-    outb(0x21, mask);
+    irq_unmask(SB16_IRQ_LINE);
 }
 
 // Disable IRQ 5 for Sound Blaster
 static void sb16_disable_irq(void)
 {
-    // Read current mask from master PIC
-    uint8_t mask = inb(0x21);
-    // Set bit 5 to disable IRQ 5
-    mask |= (1 << 5);
-    // Write back the mask
-    outb(0x21, mask);
+    irq_mask(SB16_IRQ_LINE);
 }
 
 // Sound Blaster interrupt handler wrapper
@@ -117,7 +109,7 @@ bool sb16_init(void)
         return false;
 
     // Register interrupt handler for IRQ 5 (interrupt 0x25)
-    int irq_interrupt = 0x20 + SB16_IRQ_LINE; // 0x25 for IRQ 5
+    int irq_interrupt = IRQ_VECTOR(SB16_IRQ_LINE); // 0x25 for IRQ 5
     if (idt_register_interrupt_callback(irq_interrupt, sb16_interrupt_wrapper) != 0)
     {
         return false;
@@ -540,12 +532,15 @@ uint8_t *_sb16_generate_sine_wave(uint32_t frequency, uint32_t sample_rate, uint
     if (!buffer)
         return NULL;
 
+    // fpu_sin and the doubles around it run on the x87, keep the current task's registers out of it
+    fpu_kernel_begin();
     for (uint32_t i = 0; i < duration_samples; i++)
     {
         double angle = 2.0 * 3.14159 * frequency * i / sample_rate;
         double sine_val = fpu_sin(angle);
         buffer[i] = (uint8_t)((sine_val + 1.0) * 127.5); // Convert to 0-255 range
     }
+    fpu_kernel_end();
 
     return buffer;
 }
@@ -24,9 +24,31 @@
 #define VIOS_USER_PROGRAM_STACK_SIZE 1024 * 16
 #define VIOS_PROGRAM_VIRTUAL_STACK_ADDRESS_START 0x3FF000
 #define VIOS_PROGRAM_VIRTUAL_STACK_ADDRESS_END VIOS_PROGRAM_VIRTUAL_STACK_ADDRESS_START - VIOS_USER_PROGRAM_STACK_SIZE
+// Read-only clock page shared with every process, below the stack
+#define VIOS_VCLOCK_VIRTUAL_ADDRESS 0x3F0000
 #define VIOS_MAX_PROGRAM_ALLOCATIONS 1024
 #define VIOS_MAX_PROCESSES 12
 
+#define VIOS_MAX_CPUS 8
+// Must be a power of two, and well above VIOS_MAX_PROCESSES since every task may be queued on one CPU
+#define VIOS_SCHED_RUNQUEUE_SIZE 64
+#define VIOS_MAX_TRACKED_LOCKS 32
+// Must be a power of two
+#define VIOS_FUTEX_HASH_BUCKETS 64
+#define VIOS_MAX_IPC_PORTS 32
+#define VIOS_MAX_PROCESS_FDS 16
+#define VIOS_PIPE_BUFFER_SIZE 4096
+
+#define VIOS_SYSCALL_RING_ENTRIES 64
+#define VIOS_MAX_BATCH_ENTRIES 64
+#define VIOS_MAX_VIX_COMMAND_BYTES 16384
+
+#define VIOS_MAX_SHM_REGIONS 32
+#define VIOS_MAX_PROCESS_SHM_MAPPINGS 8
+#define VIOS_SHM_MAX_SIZE 0x1000000
+#define VIOS_SHM_VIRTUAL_ADDRESS_START 0x40000000
+#define VIOS_SHM_VIRTUAL_ADDRESS_END (VIOS_SHM_VIRTUAL_ADDRESS_START + VIOS_SHM_MAX_SIZE * VIOS_MAX_PROCESS_SHM_MAPPINGS * 2)
+
 #define USER_DATA_SEGMENT 0x23
 #define USER_CODE_SEGMENT 0x1b
 
@@ -0,0 +1,169 @@
+#include "cpu.h"
+
+// Bit N is set when CPU N is online, the bootstrap processor is always CPU 0
+static volatile uint32_t cpu_online_mask = 0;
+
+static struct cpu_features cpu_features;
+
+static bool cpu_has_cpuid()
+{
+    uint32_t before;
+    uint32_t after;
+
+    // CPUID is supported when the ID flag (bit 21) in EFLAGS can be toggled
+    __asm__ __volatile__(
+        "pushfl;"
+        "pushfl;"
+        "popl %0;"
+        "movl %0, %1;"
+        "xorl $0x00200000, %1;"
+        "pushl %1;"
+        "popfl;"
+        "pushfl;"
+        "popl %1;"
+        "popfl;"
+        : "=&r"(before), "=&r"(after));
+
+    return ((before ^ after) & 0x00200000) != 0;
+}
+
+uint32_t cpu_irq_save()
+{
+    uint32_t flags;
+    __asm__ __volatile__("pushfl; popl %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+void cpu_irq_restore(uint32_t flags)
+{
+    if (flags & CPU_EFLAGS_IF)
+    {
+        __asm__ __volatile__("sti" : : : "memory");
+    }
+}
+
+void cpu_cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+    uint32_t a, b, c, d;
+    __asm__ __volatile__("cpuid"
+                         : "=a"(a), "=b"(b), "=c"(c), "=d"(d)
+                         : "a"(leaf), "c"(0));
+    *eax = a;
+    *ebx = b;
+    *ecx = c;
+    *edx = d;
+}
+
+static void cpu_detect_features()
+{
+    cpu_features.cpuid = cpu_has_cpuid();
+    if (!cpu_features.cpuid)
+    {
+        return;
+    }
+
+    uint32_t eax, ebx, ecx, edx;
+    cpu_cpuid(0, &eax, &ebx, &ecx, &edx);
+    if (eax < 1)
+    {
+        return;
+    }
+
+    cpu_cpuid(1, &eax, &ebx, &ecx, &edx);
+    cpu_features.fpu = (edx & (1 << 0)) != 0;
+    cpu_features.tsc = (edx & (1 << 4)) != 0;
+    cpu_features.msr = (edx & (1 << 5)) != 0;
+    cpu_features.apic = (edx & (1 << 9)) != 0;
+    cpu_features.pat = (edx & (1 << 16)) != 0;
+    cpu_features.fxsr = (edx & (1 << 24)) != 0;
+    cpu_features.sse = (edx & (1 << 25)) != 0;
+    cpu_features.sse2 = (edx & (1 << 26)) != 0;
+}
+
+void cpu_init()
+{
+    cpu_online_mask = 0;
+    cpu_set_online(0);
+    cpu_detect_features();
+}
+
+const struct cpu_features *cpu_get_features()
+{
+    return &cpu_features;
+}
+
+uint32_t cpu_read_cr0()
+{
+    uint32_t value;
+    __asm__ __volatile__("movl %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+void cpu_write_cr0(uint32_t value)
+{
+    __asm__ __volatile__("movl %0, %%cr0" : : "r"(value) : "memory");
+}
+
+uint32_t cpu_read_cr4()
+{
+    uint32_t value;
+    __asm__ __volatile__("movl %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+void cpu_write_cr4(uint32_t value)
+{
+    __asm__ __volatile__("movl %0, %%cr4" : : "r"(value) : "memory");
+}
+
+uint64_t cpu_read_msr(uint32_t msr)
+{
+    uint64_t value;
+    __asm__ __volatile__("rdmsr" : "=A"(value) : "c"(msr));
+    return value;
+}
+
+void cpu_write_msr(uint32_t msr, uint64_t value)
+{
+    __asm__ __volatile__("wrmsr" : : "c"(msr), "A"(value) : "memory");
+}
+
+int cpu_current_id()
+{
+    // Only the bootstrap processor runs until application processors are started
+    return 0;
+}
+
+bool cpu_is_online(int cpu)
+{
+    if (cpu < 0 || cpu >= VIOS_MAX_CPUS)
+    {
+        return false;
+    }
+
+    return (cpu_online_mask & (1 << cpu)) != 0;
+}
+
+void cpu_set_online(int cpu)
+{
+    if (cpu < 0 || cpu >= VIOS_MAX_CPUS)
+    {
+        return;
+    }
+
+    __atomic_or_fetch(&cpu_online_mask, 1 << cpu, __ATOMIC_SEQ_CST);
+}
+
+int cpu_online_count()
+{
+    int count = 0;
+    for (int i = 0; i < VIOS_MAX_CPUS; i++)
+    {
+        if (cpu_is_online(i))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,56 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+#define CPU_CR0_MP 0x00000002
+#define CPU_CR0_EM 0x00000004
+#define CPU_CR0_TS 0x00000008
+#define CPU_CR0_NE 0x00000020
+
+#define CPU_EFLAGS_IF 0x00000200
+
+#define CPU_CR4_OSFXSR 0x00000200
+#define CPU_CR4_OSXMMEXCPT 0x00000400
+
+struct cpu_features
+{
+    bool cpuid;
+    bool fpu;
+    bool tsc;
+    bool msr;
+    bool apic;
+    bool pat;
+    bool fxsr;
+    bool sse;
+    bool sse2;
+};
+
+// Returns the index of the CPU executing this code (0 .. VIOS_MAX_CPUS - 1)
+int cpu_current_id();
+
+// Number of CPUs that have been brought online
+int cpu_online_count();
+bool cpu_is_online(int cpu);
+void cpu_set_online(int cpu);
+
+void cpu_init();
+const struct cpu_features *cpu_get_features();
+void cpu_cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx);
+
+// Disables interrupts and returns the previous EFLAGS for cpu_irq_restore
+uint32_t cpu_irq_save();
+void cpu_irq_restore(uint32_t flags);
+
+uint32_t cpu_read_cr0();
+void cpu_write_cr0(uint32_t value);
+uint32_t cpu_read_cr4();
+void cpu_write_cr4(uint32_t value);
+
+// Only valid when cpu_get_features()->msr is set
+uint64_t cpu_read_msr(uint32_t msr);
+void cpu_write_msr(uint32_t msr, uint64_t value);
+
+#endif
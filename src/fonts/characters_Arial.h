@@ -0,0 +1,8 @@
+#ifndef F_ARIAL
+#define F_ARIAL
+int getArialCharacter(int index, int y);
+int getArialAdvance(int index);
+int getArialKerning(int l,int r);
+#define FONT_ARIAL_WIDTH 8
+#define FONT_ARIAL_HEIGHT 16
+#endif
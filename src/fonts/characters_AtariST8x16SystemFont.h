@@ -0,0 +1,8 @@
+#ifndef F_ATARIST8X16SYSTEMFONT
+#define F_ATARIST8X16SYSTEMFONT
+int getAtariST8x16SystemFontCharacter(int index, int y);
+int getAtariST8x16SystemFontAdvance(int index);
+int getAtariST8x16SystemFontKerning(int l,int r);
+#define FONT_ATARIST8X16SYSTEMFONT_WIDTH 8
+#define FONT_ATARIST8X16SYSTEMFONT_HEIGHT 16
+#endif
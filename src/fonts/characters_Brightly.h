@@ -0,0 +1,8 @@
+#ifndef F_BRIGHTLY
+#define F_BRIGHTLY
+int getBrightlyCharacter(int index, int y);
+int getBrightlyAdvance(int index);
+int getBrightlyKerning(int l,int r);
+#define FONT_BRIGHTLY_WIDTH 8
+#define FONT_BRIGHTLY_HEIGHT 16
+#endif
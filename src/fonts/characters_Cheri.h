@@ -0,0 +1,8 @@
+#ifndef F_CHERI
+#define F_CHERI
+int getCheriCharacter(int index, int y);
+int getCheriAdvance(int index);
+int getCheriKerning(int l,int r);
+#define FONT_CHERI_WIDTH 8
+#define FONT_CHERI_HEIGHT 16
+#endif
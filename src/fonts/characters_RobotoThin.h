@@ -0,0 +1,8 @@
+#ifndef F_ROBOTOTHIN
+#define F_ROBOTOTHIN
+int getRobotoThinCharacter(int index, int y);
+int getRobotoThinAdvance(int index);
+int getRobotoThinKerning(int l,int r);
+#define FONT_ROBOTOTHIN_WIDTH 8
+#define FONT_ROBOTOTHIN_HEIGHT 16
+#endif
@@ -7,9 +7,13 @@
 #include "fat/fat16.h"
 #include "status.h"
 #include "kernel.h"
+#include "sync/rwlock.h"
 struct filesystem *filesystems[VIOS_MAX_FILESYSTEMS];
 struct file_descriptor *file_descriptors[VIOS_MAX_FILE_DESCRIPTORS];
 
+// Lookups vastly outnumber open/close, so readers share the descriptor table
+static struct rwlock file_descriptors_lock;
+
 static struct filesystem **fs_get_free_filesystem()
 {
     int i = 0;
@@ -52,23 +56,32 @@ void fs_load()
 void fs_init()
 {
     memset(file_descriptors, 0, sizeof(file_descriptors));
+    rwlock_init(&file_descriptors_lock, "file_descriptors");
     fs_load();
 }
 
 static void file_free_descriptor(struct file_descriptor *desc)
 {
+    write_lock(&file_descriptors_lock);
     file_descriptors[desc->index - 1] = 0x00;
+    write_unlock(&file_descriptors_lock);
     kfree(desc);
 }
 
 static int file_new_descriptor(struct file_descriptor **desc_out)
 {
     int res = -ENOMEM;
+    struct file_descriptor *desc = kzalloc(sizeof(struct file_descriptor));
+    if (!desc)
+    {
+        return res;
+    }
+
+    write_lock(&file_descriptors_lock);
     for (int i = 0; i < VIOS_MAX_FILE_DESCRIPTORS; i++)
     {
         if (file_descriptors[i] == 0)
         {
-            struct file_descriptor *desc = kzalloc(sizeof(struct file_descriptor));
             // Descriptors start at 1
             desc->index = i + 1;
             file_descriptors[i] = desc;
@@ -77,6 +90,12 @@ static int file_new_descriptor(struct file_descriptor **desc_out)
             break;
         }
     }
+    write_unlock(&file_descriptors_lock);
+
+    if (res < 0)
+    {
+        kfree(desc);
+    }
 
     return res;
 }
@@ -90,7 +109,10 @@ static struct file_descriptor *file_get_descriptor(int fd)
 
     // Descriptors start at 1
     int index = fd - 1;
-    return file_descriptors[index];
+    read_lock(&file_descriptors_lock);
+    struct file_descriptor *desc = file_descriptors[index];
+    read_unlock(&file_descriptors_lock);
+    return desc;
 }
 
 struct filesystem *fs_resolve(struct disk *disk)
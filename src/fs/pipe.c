@@ -0,0 +1,145 @@
+#include "pipe.h"
+#include "config.h"
+#include "status.h"
+#include "memory/heap/kheap.h"
+
+struct pipe *pipe_new()
+{
+    struct pipe *pipe = kzalloc(sizeof(struct pipe));
+    if (!pipe)
+    {
+        return 0;
+    }
+
+    pipe->buffer = kmalloc(VIOS_PIPE_BUFFER_SIZE);
+    if (!pipe->buffer)
+    {
+        kfree(pipe);
+        return 0;
+    }
+
+    spinlock_init(&pipe->lock, 0);
+    wait_queue_init(&pipe->read_waiters);
+    wait_queue_init(&pipe->write_waiters);
+    return pipe;
+}
+
+void pipe_free(struct pipe *pipe)
+{
+    kfree(pipe->buffer);
+    kfree(pipe);
+}
+
+void pipe_open_reader(struct pipe *pipe)
+{
+    uint32_t flags = spin_lock_irqsave(&pipe->lock);
+    pipe->readers++;
+    spin_unlock_irqrestore(&pipe->lock, flags);
+}
+
+void pipe_open_writer(struct pipe *pipe)
+{
+    uint32_t flags = spin_lock_irqsave(&pipe->lock);
+    pipe->writers++;
+    spin_unlock_irqrestore(&pipe->lock, flags);
+}
+
+static void pipe_release(struct pipe *pipe, int *count, struct wait_queue *wake)
+{
+    uint32_t flags = spin_lock_irqsave(&pipe->lock);
+    (*count)--;
+    bool last_end = *count == 0;
+    bool unused = pipe->readers == 0 && pipe->writers == 0;
+    spin_unlock_irqrestore(&pipe->lock, flags);
+
+    if (unused)
+    {
+        pipe_free(pipe);
+        return;
+    }
+
+    // The other side sees end of file or a broken pipe on its next attempt
+    if (last_end)
+    {
+        wait_queue_wake_all(wake);
+    }
+}
+
+void pipe_close_reader(struct pipe *pipe)
+{
+    pipe_release(pipe, &pipe->readers, &pipe->write_waiters);
+}
+
+void pipe_close_writer(struct pipe *pipe)
+{
+    pipe_release(pipe, &pipe->writers, &pipe->read_waiters);
+}
+
+int pipe_read(struct pipe *pipe, struct task *task, char *buf, int size)
+{
+    if (size <= 0)
+    {
+        return 0;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&pipe->lock);
+    uint32_t available = pipe->tail - pipe->head;
+    if (available == 0)
+    {
+        int res = 0;
+        if (pipe->writers > 0)
+        {
+            // Queued under the pipe lock so a write can't slip in unnoticed
+            wait_queue_block(&pipe->read_waiters, task);
+            res = -EAGAIN;
+        }
+        spin_unlock_irqrestore(&pipe->lock, flags);
+        return res;
+    }
+
+    uint32_t total = (uint32_t)size < available ? (uint32_t)size : available;
+    for (uint32_t i = 0; i < total; i++)
+    {
+        buf[i] = pipe->buffer[(pipe->head + i) & (VIOS_PIPE_BUFFER_SIZE - 1)];
+    }
+    pipe->head += total;
+    spin_unlock_irqrestore(&pipe->lock, flags);
+
+    wait_queue_wake_all(&pipe->write_waiters);
+    return (int)total;
+}
+
+int pipe_write(struct pipe *pipe, struct task *task, const char *buf, int size)
+{
+    if (size <= 0)
+    {
+        return 0;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&pipe->lock);
+    if (pipe->readers == 0)
+    {
+        spin_unlock_irqrestore(&pipe->lock, flags);
+        return -EIO;
+    }
+
+    uint32_t space = VIOS_PIPE_BUFFER_SIZE - (pipe->tail - pipe->head);
+    uint32_t needed = (uint32_t)size <= VIOS_PIPE_BUFFER_SIZE ? (uint32_t)size : 1;
+    if (space < needed)
+    {
+        wait_queue_block(&pipe->write_waiters, task);
+        spin_unlock_irqrestore(&pipe->lock, flags);
+        return -EAGAIN;
+    }
+
+    uint32_t total = (uint32_t)size < space ? (uint32_t)size : space;
+    for (uint32_t i = 0; i < total; i++)
+    {
+        pipe->buffer[(pipe->tail + i) & (VIOS_PIPE_BUFFER_SIZE - 1)] = buf[i];
+    }
+    pipe->tail += total;
+    spin_unlock_irqrestore(&pipe->lock, flags);
+
+    wait_queue_wake_all(&pipe->read_waiters);
+    return (int)total;
+}
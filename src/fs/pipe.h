@@ -0,0 +1,51 @@
+#ifndef PIPE_H
+#define PIPE_H
+
+#include <stdint.h>
+#include "sync/spinlock.h"
+#include "sync/waitqueue.h"
+
+struct task;
+
+struct pipe
+{
+    // VIOS_PIPE_BUFFER_SIZE bytes, a power of two so positions wrap with a mask
+    char *buffer;
+
+    // Free-running positions, tail - head is the number of buffered bytes
+    uint32_t head;
+    uint32_t tail;
+
+    // Open descriptors referring to each end
+    int readers;
+    int writers;
+
+    struct spinlock lock;
+    struct wait_queue read_waiters;
+    struct wait_queue write_waiters;
+};
+
+struct pipe *pipe_new();
+
+// Pipes free themselves when their last end closes, this is only for one that was never opened
+void pipe_free(struct pipe *pipe);
+
+void pipe_open_reader(struct pipe *pipe);
+void pipe_open_writer(struct pipe *pipe);
+void pipe_close_reader(struct pipe *pipe);
+void pipe_close_writer(struct pipe *pipe);
+
+/**
+ * Returns the bytes read, 0 at end of file once every writer has closed,
+ * or -EAGAIN after queueing the task to be woken when data arrives.
+ */
+int pipe_read(struct pipe *pipe, struct task *task, char *buf, int size);
+
+/**
+ * Writes of up to VIOS_PIPE_BUFFER_SIZE bytes are all or nothing.
+ * Returns the bytes written, -EIO when there are no readers left,
+ * or -EAGAIN after queueing the task to be woken when space frees up.
+ */
+int pipe_write(struct pipe *pipe, struct task *task, const char *buf, int size);
+
+#endif
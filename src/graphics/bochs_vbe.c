@@ -0,0 +1,66 @@
+#include "bochs_vbe.h"
+#include "io/io.h"
+#include "time/ktime.h"
+
+static uint16_t bochs_vbe_read(uint16_t index)
+{
+    outw(BOCHS_VBE_INDEX_PORT, index);
+    return insw(BOCHS_VBE_DATA_PORT);
+}
+
+static void bochs_vbe_write(uint16_t index, uint16_t value)
+{
+    outw(BOCHS_VBE_INDEX_PORT, index);
+    outw(BOCHS_VBE_DATA_PORT, value);
+}
+
+bool bochs_vbe_detect()
+{
+    uint16_t id = bochs_vbe_read(BOCHS_VBE_INDEX_ID);
+    return id >= BOCHS_VBE_ID_MIN && id <= BOCHS_VBE_ID_MAX;
+}
+
+bool bochs_vbe_set_virtual_pages(uint16_t height, int pages)
+{
+    uint32_t virtual_height = (uint32_t)height * pages;
+    if (pages < 1 || virtual_height > 0xFFFF)
+    {
+        return false;
+    }
+
+    // The adapter clamps the virtual height to what fits in video memory, read it back to know
+    bochs_vbe_write(BOCHS_VBE_INDEX_VIRT_HEIGHT, virtual_height);
+    if (bochs_vbe_read(BOCHS_VBE_INDEX_VIRT_HEIGHT) < virtual_height)
+    {
+        bochs_vbe_write(BOCHS_VBE_INDEX_VIRT_HEIGHT, height);
+        return false;
+    }
+
+    bochs_vbe_set_y_offset(0);
+    return true;
+}
+
+void bochs_vbe_set_y_offset(uint16_t y)
+{
+    bochs_vbe_write(BOCHS_VBE_INDEX_Y_OFFSET, y);
+}
+
+static bool bochs_vbe_in_retrace()
+{
+    return insb(BOCHS_VBE_VGA_STATUS_PORT) & BOCHS_VBE_VGA_STATUS_RETRACE;
+}
+
+void bochs_vbe_wait_retrace(uint64_t deadline_ns)
+{
+    // Let a retrace that is already under way finish, the offset may have missed it
+    int spins = 0;
+    while (bochs_vbe_in_retrace() && spins < BOCHS_VBE_RETRACE_SPIN_LIMIT && ktime_ns() < deadline_ns)
+    {
+        spins++;
+    }
+
+    while (!bochs_vbe_in_retrace() && spins < BOCHS_VBE_RETRACE_SPIN_LIMIT && ktime_ns() < deadline_ns)
+    {
+        spins++;
+    }
+}
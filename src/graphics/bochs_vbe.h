@@ -0,0 +1,50 @@
+#ifndef BOCHS_VBE_H
+#define BOCHS_VBE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bochs/QEMU display interface (DISPI), an index/data register pair
+#define BOCHS_VBE_INDEX_PORT 0x01CE
+#define BOCHS_VBE_DATA_PORT 0x01CF
+
+#define BOCHS_VBE_INDEX_ID 0x00
+#define BOCHS_VBE_INDEX_XRES 0x01
+#define BOCHS_VBE_INDEX_YRES 0x02
+#define BOCHS_VBE_INDEX_BPP 0x03
+#define BOCHS_VBE_INDEX_ENABLE 0x04
+#define BOCHS_VBE_INDEX_VIRT_WIDTH 0x06
+#define BOCHS_VBE_INDEX_VIRT_HEIGHT 0x07
+#define BOCHS_VBE_INDEX_X_OFFSET 0x08
+#define BOCHS_VBE_INDEX_Y_OFFSET 0x09
+
+// Any id from the first interface revision up understands virtual heights and offsets
+#define BOCHS_VBE_ID_MIN 0xB0C0
+#define BOCHS_VBE_ID_MAX 0xB0CF
+
+// VGA input status register 1, bit 3 is set while the display is in vertical retrace
+#define BOCHS_VBE_VGA_STATUS_PORT 0x3DA
+#define BOCHS_VBE_VGA_STATUS_RETRACE 0x08
+
+// Status reads to give up after when ktime can't measure the deadline, roughly a frame's worth
+#define BOCHS_VBE_RETRACE_SPIN_LIMIT 20000
+
+bool bochs_vbe_detect();
+
+/**
+ * Grows the virtual screen to pages * height lines so the spare pages can be drawn into
+ * off screen. Fails when the adapter's video memory can't hold them.
+ */
+bool bochs_vbe_set_virtual_pages(uint16_t height, int pages);
+
+// Scans out starting at line y of the virtual screen, takes effect on the next refresh
+void bochs_vbe_set_y_offset(uint16_t y);
+
+/**
+ * Waits for the start of the next vertical retrace, after which an offset set before the call
+ * is being scanned out. Gives up at deadline_ns (ktime), or after BOCHS_VBE_RETRACE_SPIN_LIMIT
+ * reads, on adapters that never report one.
+ */
+void bochs_vbe_wait_retrace(uint64_t deadline_ns);
+
+#endif
@@ -0,0 +1,365 @@
+#include "compositor.h"
+#include "status.h"
+#include "memory/memory.h"
+#include "memory/heap/kheap.h"
+#include "sync/spinlock.h"
+
+struct compositor_window
+{
+    bool used;
+    struct process *owner;
+    GraphicsSurface *surface;
+
+    // Screen position, the size is the surface's
+    int x, y;
+
+    // VIX calls from the owner draw into this window
+    bool target;
+};
+
+static struct compositor_window compositor_windows[COMPOSITOR_MAX_WINDOWS];
+
+// Open windows from the bottom up
+static struct compositor_window *compositor_order[COMPOSITOR_MAX_WINDOWS];
+static int compositor_window_count;
+
+static Rectangle compositor_exposed[COMPOSITOR_MAX_EXPOSED];
+static int compositor_exposed_count;
+
+// Covers the window table, the order and the exposed list
+static struct spinlock compositor_lock;
+
+void compositor_init(void)
+{
+    memset(compositor_windows, 0, sizeof(compositor_windows));
+    compositor_window_count = 0;
+    compositor_exposed_count = 0;
+    spinlock_init(&compositor_lock, "compositor");
+}
+
+static Rectangle compositor_frame(struct compositor_window *window)
+{
+    return (Rectangle){window->x, window->y, window->surface->width, window->surface->height};
+}
+
+static Rectangle compositor_intersect(Rectangle a, Rectangle b)
+{
+    int x1 = a.x > b.x ? a.x : b.x;
+    int y1 = a.y > b.y ? a.y : b.y;
+    int x2 = a.x + a.width < b.x + b.width ? a.x + a.width : b.x + b.width;
+    int y2 = a.y + a.height < b.y + b.height ? a.y + a.height : b.y + b.height;
+    if (x1 >= x2 || y1 >= y2)
+        return (Rectangle){0, 0, 0, 0};
+    return (Rectangle){x1, y1, x2 - x1, y2 - y1};
+}
+
+static bool compositor_contains(Rectangle outer, Rectangle inner)
+{
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+static void compositor_expose(Rectangle area)
+{
+    if (area.width <= 0 || area.height <= 0)
+        return;
+
+    if (compositor_exposed_count < COMPOSITOR_MAX_EXPOSED)
+    {
+        compositor_exposed[compositor_exposed_count++] = area;
+        return;
+    }
+
+    Rectangle *last = &compositor_exposed[COMPOSITOR_MAX_EXPOSED - 1];
+    int x1 = area.x < last->x ? area.x : last->x;
+    int y1 = area.y < last->y ? area.y : last->y;
+    int x2 = area.x + area.width > last->x + last->width ? area.x + area.width : last->x + last->width;
+    int y2 = area.y + area.height > last->y + last->height ? area.y + area.height : last->y + last->height;
+    *last = (Rectangle){x1, y1, x2 - x1, y2 - y1};
+}
+
+static struct compositor_window *compositor_window_get(struct process *process, int window_id)
+{
+    // Window ids start at 1
+    if (window_id <= 0 || window_id > COMPOSITOR_MAX_WINDOWS)
+        return 0;
+
+    struct compositor_window *window = &compositor_windows[window_id - 1];
+    return window->used && window->owner == process ? window : 0;
+}
+
+static int compositor_order_index(struct compositor_window *window)
+{
+    for (int i = 0; i < compositor_window_count; i++)
+    {
+        if (compositor_order[i] == window)
+            return i;
+    }
+    return -1;
+}
+
+static void compositor_order_remove(struct compositor_window *window)
+{
+    int index = compositor_order_index(window);
+    for (int i = index; i < compositor_window_count - 1; i++)
+    {
+        compositor_order[i] = compositor_order[i + 1];
+    }
+    compositor_window_count--;
+}
+
+static void compositor_select_locked(struct process *process, struct compositor_window *selected)
+{
+    for (int i = 0; i < COMPOSITOR_MAX_WINDOWS; i++)
+    {
+        struct compositor_window *window = &compositor_windows[i];
+        if (window->used && window->owner == process)
+            window->target = window == selected;
+    }
+}
+
+int compositor_window_create(struct process *process, Rectangle frame)
+{
+    GraphicsContext *ctx = graphics_get_context();
+    if (!ctx || frame.width <= 0 || frame.height <= 0 ||
+        frame.width > ctx->current_mode.width || frame.height > ctx->current_mode.height)
+    {
+        return -EINVARG;
+    }
+
+    GraphicsSurface *surface = graphics_create_surface(frame.width, frame.height);
+    if (!surface)
+        return -ENOMEM;
+
+    surface->pixels = kzalloc(frame.width * frame.height * sizeof(Color));
+    if (!surface->pixels)
+    {
+        graphics_destroy_surface(surface);
+        return -ENOMEM;
+    }
+
+    // Starts out fully damaged so the first present shows it
+    surface->track_damage = true;
+    surface->damage = (Rectangle){0, 0, frame.width, frame.height};
+
+    int res = -EISTKN;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    for (int i = 0; i < COMPOSITOR_MAX_WINDOWS; i++)
+    {
+        struct compositor_window *window = &compositor_windows[i];
+        if (window->used)
+            continue;
+
+        window->used = true;
+        window->owner = process;
+        window->surface = surface;
+        window->x = frame.x;
+        window->y = frame.y;
+        compositor_order[compositor_window_count++] = window;
+        compositor_select_locked(process, window);
+        res = i + 1;
+        break;
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+
+    if (res < 0)
+    {
+        kfree(surface->pixels);
+        graphics_destroy_surface(surface);
+    }
+
+    return res;
+}
+
+static void compositor_destroy_locked(struct compositor_window *window)
+{
+    compositor_expose(compositor_frame(window));
+    compositor_order_remove(window);
+
+    kfree(window->surface->pixels);
+    graphics_destroy_surface(window->surface);
+    memset(window, 0, sizeof(struct compositor_window));
+}
+
+int compositor_window_destroy(struct process *process, int window_id)
+{
+    int res = -EINVARG;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    struct compositor_window *window = compositor_window_get(process, window_id);
+    if (window)
+    {
+        compositor_destroy_locked(window);
+        res = 0;
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+    return res;
+}
+
+int compositor_window_move(struct process *process, int window_id, int x, int y)
+{
+    int res = -EINVARG;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    struct compositor_window *window = compositor_window_get(process, window_id);
+    if (window)
+    {
+        // What it covered shows again, the new spot is repainted from the window
+        compositor_expose(compositor_frame(window));
+        window->x = x;
+        window->y = y;
+        compositor_expose(compositor_frame(window));
+        res = 0;
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+    return res;
+}
+
+int compositor_window_raise(struct process *process, int window_id)
+{
+    int res = -EINVARG;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    struct compositor_window *window = compositor_window_get(process, window_id);
+    if (window)
+    {
+        compositor_order_remove(window);
+        compositor_order[compositor_window_count++] = window;
+        compositor_expose(compositor_frame(window));
+        res = 0;
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+    return res;
+}
+
+int compositor_window_select(struct process *process, int window_id)
+{
+    int res = -EINVARG;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    struct compositor_window *window = compositor_window_get(process, window_id);
+    if (window || window_id == 0)
+    {
+        compositor_select_locked(process, window);
+        res = 0;
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+    return res;
+}
+
+GraphicsSurface *compositor_target(struct process *process)
+{
+    GraphicsSurface *surface = 0;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    for (int i = 0; i < COMPOSITOR_MAX_WINDOWS; i++)
+    {
+        struct compositor_window *window = &compositor_windows[i];
+        if (window->used && window->owner == process && window->target)
+        {
+            surface = window->surface;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+
+    if (!surface)
+    {
+        GraphicsContext *ctx = graphics_get_context();
+        surface = ctx ? ctx->back_buffer : 0;
+    }
+    return surface;
+}
+
+// Redraws one screen area from the windows, clipped to it through the back buffer's clip rectangle
+static void compositor_repaint(GraphicsSurface *screen, Rectangle area, bool exposed)
+{
+    Rectangle clip = screen->clip_rect;
+    Rectangle bounds = {0, 0, screen->width, screen->height};
+    area = compositor_intersect(area, bounds);
+    if (!area.width)
+        return;
+
+    // Windows are opaque, nothing below the topmost one covering the whole area shows through
+    int first = 0;
+    for (int i = compositor_window_count - 1; i >= 0; i--)
+    {
+        if (compositor_contains(compositor_frame(compositor_order[i]), area))
+        {
+            first = i;
+            exposed = false;
+            break;
+        }
+    }
+
+    if (exposed)
+        graphics_fill_rect(screen, area, COMPOSITOR_BACKGROUND);
+
+    screen->clip_rect = area;
+    for (int i = first; i < compositor_window_count; i++)
+    {
+        struct compositor_window *window = compositor_order[i];
+        if (!compositor_intersect(compositor_frame(window), area).width)
+            continue;
+
+        graphics_blit_surface(screen, window->surface, NULL, (Point){window->x, window->y});
+    }
+    screen->clip_rect = clip;
+}
+
+void compositor_present(void)
+{
+    GraphicsContext *ctx = graphics_get_context();
+    if (!ctx || !ctx->back_buffer)
+        return;
+
+    GraphicsSurface *screen = ctx->back_buffer;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    for (int i = 0; i < compositor_exposed_count; i++)
+    {
+        compositor_repaint(screen, compositor_exposed[i], true);
+    }
+    compositor_exposed_count = 0;
+
+    for (int i = 0; i < compositor_window_count; i++)
+    {
+        struct compositor_window *window = compositor_order[i];
+        Rectangle damage = window->surface->damage;
+        if (!damage.width)
+            continue;
+
+        damage.x += window->x;
+        damage.y += window->y;
+        compositor_repaint(screen, damage, false);
+        window->surface->damage = (Rectangle){0, 0, 0, 0};
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+
+    graphics_present();
+}
+
+void compositor_process_exit(struct process *process)
+{
+    bool closed = false;
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    for (int i = 0; i < COMPOSITOR_MAX_WINDOWS; i++)
+    {
+        struct compositor_window *window = &compositor_windows[i];
+        if (window->used && window->owner == process)
+        {
+            compositor_destroy_locked(window);
+            closed = true;
+        }
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+
+    // The process won't present again, take its windows off the screen now
+    if (closed)
+        compositor_present();
+}
+
+void compositor_expose_windows(void)
+{
+    uint32_t flags = spin_lock_irqsave(&compositor_lock);
+    for (int i = 0; i < compositor_window_count; i++)
+    {
+        compositor_expose(compositor_frame(compositor_order[i]));
+    }
+    spin_unlock_irqrestore(&compositor_lock, flags);
+}
@@ -0,0 +1,60 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "graphics.h"
+
+struct process;
+
+#define COMPOSITOR_MAX_WINDOWS 16
+
+// Screen areas uncovered by moves and closes, merged into the last one when full
+#define COMPOSITOR_MAX_EXPOSED 16
+
+// Shows through wherever no window covers the screen
+#define COMPOSITOR_BACKGROUND COLOR_BLACK
+
+enum compositor_window_op
+{
+    COMPOSITOR_WINDOW_DESTROY,
+    COMPOSITOR_WINDOW_MOVE,
+    COMPOSITOR_WINDOW_RAISE,
+    COMPOSITOR_WINDOW_SELECT,
+};
+
+void compositor_init(void);
+
+/**
+ * Opens an opaque window owned by process at frame, on top of every other window.
+ * It becomes the process' drawing target. Returns the window id or a negative status.
+ */
+int compositor_window_create(struct process *process, Rectangle frame);
+
+int compositor_window_destroy(struct process *process, int window_id);
+int compositor_window_move(struct process *process, int window_id, int x, int y);
+int compositor_window_raise(struct process *process, int window_id);
+
+// Makes window_id the process' drawing target, 0 draws straight into the back buffer again
+int compositor_window_select(struct process *process, int window_id);
+
+/**
+ * Where VIX drawing from process lands: its selected window's surface, or the back buffer
+ * for processes without one.
+ */
+GraphicsSurface *compositor_target(struct process *process);
+
+/**
+ * Repaints the exposed areas and each window's damage in z-order into the back buffer,
+ * then presents. Untouched screen areas aren't copied at all.
+ */
+void compositor_present(void);
+
+// Closes the process' windows and presents, so they leave the screen without waiting for another client
+void compositor_process_exit(struct process *process);
+
+/**
+ * Marks every open window exposed, for when something overwrote the whole back buffer.
+ * The next compositor_present puts them back on top.
+ */
+void compositor_expose_windows(void);
+
+#endif
@@ -0,0 +1,178 @@
+#include "cursor.h"
+#include "sync/spinlock.h"
+
+static const uint16_t cursor_pattern[10] = {
+    0b1111111111,
+    0b1111111110,
+    0b1111111100,
+    0b1111111000,
+    0b1111110000,
+    0b1111100000,
+    0b1111000000,
+    0b1110000000,
+    0b1100000000,
+    0b1000000000,
+};
+
+static struct
+{
+    bool visible;
+    Color color;
+
+    // Where the cursor should be, and where it currently sits in the visible page
+    int x, y;
+    bool drawn;
+    int drawn_x, drawn_y;
+
+    // Set while a present owns the visible page
+    bool presenting;
+
+    // Visible page pixels the drawn cursor covers
+    uint16_t under[CURSOR_SIZE * CURSOR_SIZE];
+} cursor;
+
+static struct spinlock cursor_lock;
+
+void cursor_init(void)
+{
+    cursor.visible = false;
+    cursor.color = COLOR_WHITE;
+    cursor.drawn = false;
+    cursor.presenting = false;
+    spinlock_init(&cursor_lock, "cursor");
+}
+
+// The part of the cursor box at x, y that is on screen, false when none of it is
+static bool cursor_bounds(int x, int y, int *x1, int *y1, int *x2, int *y2)
+{
+    GraphicsContext *ctx = graphics_get_context();
+    *x1 = x < 0 ? 0 : x;
+    *y1 = y < 0 ? 0 : y;
+    *x2 = x + CURSOR_SIZE > ctx->current_mode.width ? ctx->current_mode.width : x + CURSOR_SIZE;
+    *y2 = y + CURSOR_SIZE > ctx->current_mode.height ? ctx->current_mode.height : y + CURSOR_SIZE;
+    return *x1 < *x2 && *y1 < *y2;
+}
+
+static void cursor_erase(void)
+{
+    if (!cursor.drawn)
+        return;
+
+    GraphicsSurface *screen = graphics_get_context()->front_buffer;
+    int x1, y1, x2, y2;
+    if (cursor_bounds(cursor.drawn_x, cursor.drawn_y, &x1, &y1, &x2, &y2))
+    {
+        for (int y = y1; y < y2; y++)
+        {
+            const uint16_t *saved = &cursor.under[(y - cursor.drawn_y) * CURSOR_SIZE + (x1 - cursor.drawn_x)];
+            uint16_t *row = &screen->pixels[y * screen->width];
+            for (int x = x1; x < x2; x++)
+            {
+                row[x] = *saved++;
+            }
+        }
+    }
+
+    cursor.drawn = false;
+}
+
+static void cursor_draw(void)
+{
+    GraphicsContext *ctx = graphics_get_context();
+    if (!cursor.visible || cursor.presenting || !ctx || !ctx->front_buffer || !ctx->front_buffer->pixels)
+        return;
+
+    GraphicsSurface *screen = ctx->front_buffer;
+    int x1, y1, x2, y2;
+    if (!cursor_bounds(cursor.x, cursor.y, &x1, &y1, &x2, &y2))
+        return;
+
+    // Save first, the shadow of one row lands on the next
+    for (int y = y1; y < y2; y++)
+    {
+        uint16_t *saved = &cursor.under[(y - cursor.y) * CURSOR_SIZE + (x1 - cursor.x)];
+        const uint16_t *row = &screen->pixels[y * screen->width];
+        for (int x = x1; x < x2; x++)
+        {
+            *saved++ = row[x];
+        }
+    }
+
+    for (int shadow = 1; shadow >= 0; shadow--)
+    {
+        Color color = shadow ? COLOR_BLACK : cursor.color;
+        for (int row = 0; row < 10; row++)
+        {
+            int y = cursor.y + row + shadow;
+            if (y < y1 || y >= y2)
+                continue;
+
+            for (int col = 0; col < 10; col++)
+            {
+                int x = cursor.x + col + shadow;
+                if (x >= x1 && x < x2 && (cursor_pattern[row] & (1 << (9 - col))))
+                    screen->pixels[y * screen->width + x] = color;
+            }
+        }
+    }
+
+    cursor.drawn = true;
+    cursor.drawn_x = cursor.x;
+    cursor.drawn_y = cursor.y;
+}
+
+void cursor_show(bool visible)
+{
+    uint32_t flags = spin_lock_irqsave(&cursor_lock);
+    if (visible != cursor.visible)
+    {
+        cursor.visible = visible;
+        cursor_erase();
+        cursor_draw();
+    }
+    spin_unlock_irqrestore(&cursor_lock, flags);
+}
+
+void cursor_set_color(Color color)
+{
+    uint32_t flags = spin_lock_irqsave(&cursor_lock);
+    if (color != cursor.color)
+    {
+        cursor.color = color;
+        cursor_erase();
+        cursor_draw();
+    }
+    spin_unlock_irqrestore(&cursor_lock, flags);
+}
+
+void cursor_move(int x, int y)
+{
+    uint32_t flags = spin_lock_irqsave(&cursor_lock);
+    if (!cursor.drawn || x != cursor.drawn_x || y != cursor.drawn_y)
+    {
+        cursor.x = x;
+        cursor.y = y;
+        if (!cursor.presenting)
+        {
+            cursor_erase();
+            cursor_draw();
+        }
+    }
+    spin_unlock_irqrestore(&cursor_lock, flags);
+}
+
+void cursor_present_begin(void)
+{
+    uint32_t flags = spin_lock_irqsave(&cursor_lock);
+    cursor.presenting = true;
+    cursor_erase();
+    spin_unlock_irqrestore(&cursor_lock, flags);
+}
+
+void cursor_present_end(void)
+{
+    uint32_t flags = spin_lock_irqsave(&cursor_lock);
+    cursor.presenting = false;
+    cursor_draw();
+    spin_unlock_irqrestore(&cursor_lock, flags);
+}
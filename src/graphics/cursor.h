@@ -0,0 +1,26 @@
+#ifndef CURSOR_H
+#define CURSOR_H
+
+#include <stdbool.h>
+#include "graphics.h"
+
+// 10x10 arrow plus its one pixel shadow
+#define CURSOR_SIZE 11
+
+/**
+ * Mouse cursor overlay. It is drawn straight into the visible page over a saved copy of
+ * the pixels beneath it, so moving it rewrites a couple of hundred pixels and never
+ * damages or presents the back buffer.
+ */
+void cursor_init(void);
+void cursor_show(bool visible);
+void cursor_set_color(Color color);
+
+// Safe from deferred interrupt work, a move during a present is picked up when it ends
+void cursor_move(int x, int y);
+
+// Presents take the cursor out of the visible page while they copy or flip, then put it back
+void cursor_present_begin(void);
+void cursor_present_end(void);
+
+#endif
@@ -0,0 +1,84 @@
+#include "glyph_cache.h"
+#include "fonts/characters_AtariST8x16SystemFont.h"
+#include "memory/heap/kheap.h"
+#include "memory/memory.h"
+
+static struct glyph_atlas *glyph_atlases[GLYPH_CACHE_MAX_SCALE + 1];
+
+static void glyph_cache_rasterize(struct glyph_atlas *atlas, int index)
+{
+    int glyph_size = atlas->glyph_width * atlas->glyph_height;
+    uint16_t *mask = &atlas->masks[index * glyph_size];
+    bool blank = true;
+
+    for (int char_y = 0; char_y < FONT_ATARIST8X16SYSTEMFONT_HEIGHT; char_y++)
+    {
+        unsigned int char_row = getAtariST8x16SystemFontCharacter(GLYPH_CACHE_FIRST + index, char_y);
+        uint16_t *row = &mask[char_y * atlas->scale * atlas->glyph_width];
+
+        for (int char_x = 0; char_x < FONT_ATARIST8X16SYSTEMFONT_WIDTH; char_x++)
+        {
+            if (char_row & (1 << (FONT_ATARIST8X16SYSTEMFONT_WIDTH - 1 - char_x)))
+            {
+                memset16(&row[char_x * atlas->scale], 0xFFFF, atlas->scale);
+                blank = false;
+            }
+        }
+
+        // The remaining rows of a scaled font row are copies of the first
+        for (int sy = 1; sy < atlas->scale; sy++)
+        {
+            memcpy(&row[sy * atlas->glyph_width], row, atlas->glyph_width * sizeof(uint16_t));
+        }
+    }
+
+    atlas->blank[index] = blank;
+}
+
+const struct glyph_atlas *glyph_cache_get(int scale)
+{
+    if (scale < 1 || scale > GLYPH_CACHE_MAX_SCALE)
+    {
+        return 0;
+    }
+
+    if (glyph_atlases[scale])
+    {
+        return glyph_atlases[scale];
+    }
+
+    struct glyph_atlas *atlas = kzalloc(sizeof(struct glyph_atlas));
+    if (!atlas)
+    {
+        return 0;
+    }
+
+    atlas->scale = scale;
+    atlas->glyph_width = FONT_ATARIST8X16SYSTEMFONT_WIDTH * scale;
+    atlas->glyph_height = FONT_ATARIST8X16SYSTEMFONT_HEIGHT * scale;
+    atlas->masks = kzalloc(GLYPH_CACHE_COUNT * atlas->glyph_width * atlas->glyph_height * sizeof(uint16_t));
+    if (!atlas->masks)
+    {
+        kfree(atlas);
+        return 0;
+    }
+
+    for (int i = 0; i < GLYPH_CACHE_COUNT; i++)
+    {
+        glyph_cache_rasterize(atlas, i);
+    }
+
+    glyph_atlases[scale] = atlas;
+    return atlas;
+}
+
+const uint16_t *glyph_atlas_mask(const struct glyph_atlas *atlas, char c)
+{
+    int index = (unsigned char)c - GLYPH_CACHE_FIRST;
+    if (index < 0 || index >= GLYPH_CACHE_COUNT || atlas->blank[index])
+    {
+        return 0;
+    }
+
+    return &atlas->masks[index * atlas->glyph_width * atlas->glyph_height];
+}
@@ -0,0 +1,34 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The generated fonts only carry printable ASCII
+#define GLYPH_CACHE_FIRST 32
+#define GLYPH_CACHE_LAST 126
+#define GLYPH_CACHE_COUNT (GLYPH_CACHE_LAST - GLYPH_CACHE_FIRST + 1)
+
+// Atlases grow with the square of the scale, larger text is rasterized directly
+#define GLYPH_CACHE_MAX_SCALE 4
+
+/**
+ * Every glyph of the Atari ST 8x16 font expanded once at one scale. Masks are RGB565 sized,
+ * 0xFFFF where the glyph is lit, so a blit is a row walk with no font lookups.
+ */
+struct glyph_atlas
+{
+    int scale;
+    int glyph_width;
+    int glyph_height;
+    uint16_t *masks;
+    bool blank[GLYPH_CACHE_COUNT];
+};
+
+// Builds the atlas on first use, NULL when the scale isn't cached or memory ran out
+const struct glyph_atlas *glyph_cache_get(int scale);
+
+// Mask of glyph_width * glyph_height entries, NULL for characters that draw nothing
+const uint16_t *glyph_atlas_mask(const struct glyph_atlas *atlas, char c);
+
+#endif
@@ -1,45 +1,36 @@
 #include "graphics.h"
 #include "memory/heap/kheap.h"
 #include "memory/memory.h"
+#include "memory/paging/paging.h"
 #include "rtc/rtc.h"
 #include "math/fpu_math.h"
 #include "idt/idt.h"
 #include "io/io.h"
 #include "debug/simple_serial.h"
 #include "string/string.h"
+#include "time/ktime.h"
+#include "math/div64.h"
+#include "time/vclock.h"
+#include "bochs_vbe.h"
+#include "glyph_cache.h"
+#include "cursor.h"
+#include "compositor.h"
 
 // Global graphics context - Windows-level architecture
 static GraphicsContext g_graphics_context;
 static bool g_graphics_initialized = false;
 
 // Performance tracking variables
-static uint32_t g_frame_time_start = 0;
-static uint32_t g_total_render_time = 0;
+static uint64_t g_frame_time_start = 0;
+static uint64_t g_total_render_time = 0;
 static uint32_t g_frames_rendered = 0;
 
 // =================== INTERNAL UTILITY FUNCTIONS ===================
 
-// PIT-based millisecond timer for accurate FPS measurement
-static uint32_t g_pit_ticks = 0;
-static uint32_t g_pit_divisor = 1193; // For ~1ms intervals
-
-void _graphics_init_pit_timer(void)
-{
-    // Configure PIT channel 0 for ~1ms intervals
-    outb(0x43, 0x36);                        // Mode 3, 16-bit binary
-    outb(0x40, g_pit_divisor & 0xFF);        // Low byte
-    outb(0x40, (g_pit_divisor >> 8) & 0xFF); // High byte
-}
-
-void _graphics_pit_tick(void)
-{
-    g_pit_ticks++;
-}
-
 uint32_t _graphics_get_time_ms(void)
 {
-    // Return milliseconds since boot using PIT ticks
-    return g_pit_ticks;
+    // Milliseconds since boot from the kernel clocksource
+    return ktime_ms();
 }
 
 bool _graphics_is_point_visible(GraphicsSurface *surface, Point point)
@@ -69,6 +60,159 @@ void _graphics_update_fps_counter(void)
     }
 }
 
+static int _graphics_rect_area(Rectangle rect)
+{
+    return rect.width * rect.height;
+}
+
+static Rectangle _graphics_rect_union(Rectangle a, Rectangle b)
+{
+    int x1 = a.x < b.x ? a.x : b.x;
+    int y1 = a.y < b.y ? a.y : b.y;
+    int x2 = a.x + a.width > b.x + b.width ? a.x + a.width : b.x + b.width;
+    int y2 = a.y + a.height > b.y + b.height ? a.y + a.height : b.y + b.height;
+    return (Rectangle){x1, y1, x2 - x1, y2 - y1};
+}
+
+// Overlapping or edge sharing rectangles, a row of glyphs collapses into one span this way
+static bool _graphics_rects_touch(Rectangle a, Rectangle b)
+{
+    return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+           a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+static void _graphics_copy_rect(GraphicsSurface *dest, GraphicsSurface *src, Rectangle rect)
+{
+    for (int y = rect.y; y < rect.y + rect.height; y++)
+    {
+        int offset = y * g_graphics_context.current_mode.width + rect.x;
+        memcpy_stream(&dest->pixels[offset], &src->pixels[offset], rect.width * GRAPHICS_BYTES_PER_PIXEL);
+    }
+}
+
+// Called before the back page is written, drawing into it while it is still scanned out tears
+static void _graphics_finish_flip(void)
+{
+    GraphicsContext *ctx = &g_graphics_context;
+    if (!ctx->flip_pending)
+        return;
+
+    ctx->flip_pending = false;
+
+    // The display moves to the new page within one refresh of the flip, past that there is nothing to wait for
+    int refresh_rate = ctx->current_mode.refresh_rate > 0 ? ctx->current_mode.refresh_rate : 60;
+    uint64_t deadline = ctx->flip_time_ns + 1000000000u / refresh_rate;
+    if (ktime_ns() < deadline)
+        bochs_vbe_wait_retrace(deadline);
+}
+
+// After a flip the back page holds the frame before last, bring it up to date before drawing
+static void _graphics_repair_back_page(void)
+{
+    GraphicsContext *ctx = &g_graphics_context;
+
+    // The cursor overlay sits in the front page, it must not be copied along
+    cursor_present_begin();
+    if (ctx->stale_full)
+    {
+        Rectangle screen = {0, 0, ctx->current_mode.width, ctx->current_mode.height};
+        _graphics_copy_rect(ctx->back_buffer, ctx->front_buffer, screen);
+    }
+    else
+    {
+        for (int i = 0; i < ctx->stale_count; i++)
+        {
+            _graphics_copy_rect(ctx->back_buffer, ctx->front_buffer, ctx->stale[i]);
+        }
+    }
+
+    cursor_present_end();
+
+    ctx->stale_full = false;
+    ctx->stale_count = 0;
+}
+
+// Off screen surfaces only keep one box, the compositor repaints it in a single pass
+static void _graphics_damage_offscreen(GraphicsSurface *surface, int x, int y, int width, int height)
+{
+    int x1 = x < 0 ? 0 : x;
+    int y1 = y < 0 ? 0 : y;
+    int x2 = x + width > surface->width ? surface->width : x + width;
+    int y2 = y + height > surface->height ? surface->height : y + height;
+    if (x1 >= x2 || y1 >= y2)
+        return;
+
+    Rectangle rect = {x1, y1, x2 - x1, y2 - y1};
+    surface->damage = surface->damage.width ? _graphics_rect_union(surface->damage, rect) : rect;
+}
+
+void _graphics_damage_surface(GraphicsSurface *surface, int x, int y, int width, int height)
+{
+    if (surface && surface->track_damage)
+    {
+        _graphics_damage_offscreen(surface, x, y, width, height);
+        return;
+    }
+
+    if (!surface || surface != g_graphics_context.back_buffer)
+        return;
+
+    _graphics_finish_flip();
+    if (g_graphics_context.stale_full || g_graphics_context.stale_count)
+        _graphics_repair_back_page();
+
+    if (g_graphics_context.needs_full_refresh)
+        return;
+
+    // Clamp to the screen, off screen drawing leaves nothing to present
+    int x1 = x < 0 ? 0 : x;
+    int y1 = y < 0 ? 0 : y;
+    int x2 = x + width > surface->width ? surface->width : x + width;
+    int y2 = y + height > surface->height ? surface->height : y + height;
+    if (x1 >= x2 || y1 >= y2)
+        return;
+
+    Rectangle rect = {x1, y1, x2 - x1, y2 - y1};
+
+    // Absorb every rectangle the new one touches, the union can reach further ones
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (int i = 0; i < g_graphics_context.damage_count; i++)
+        {
+            if (_graphics_rects_touch(rect, g_graphics_context.damage[i]))
+            {
+                rect = _graphics_rect_union(rect, g_graphics_context.damage[i]);
+                g_graphics_context.damage[i] = g_graphics_context.damage[--g_graphics_context.damage_count];
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    if (g_graphics_context.damage_count < GRAPHICS_MAX_DAMAGE_RECTS)
+    {
+        g_graphics_context.damage[g_graphics_context.damage_count++] = rect;
+        return;
+    }
+
+    // List is full, grow whichever rectangle the new one adds the least area to
+    int best = 0;
+    int best_growth = 0;
+    for (int i = 0; i < g_graphics_context.damage_count; i++)
+    {
+        Rectangle grown = _graphics_rect_union(rect, g_graphics_context.damage[i]);
+        int growth = _graphics_rect_area(grown) - _graphics_rect_area(g_graphics_context.damage[i]);
+        if (i == 0 || growth < best_growth)
+        {
+            best = i;
+            best_growth = growth;
+        }
+    }
+    g_graphics_context.damage[best] = _graphics_rect_union(rect, g_graphics_context.damage[best]);
+}
+
 bool _graphics_init_framebuffer(void)
 {
     VBEInfoBlock *vbe = (VBEInfoBlock *)VBEInfoAddress;
@@ -96,6 +240,17 @@ void _graphics_init_surfaces(void)
     if (!vbe)
         return;
 
+    uint32_t line_bytes = vbe->bytes_per_scan_line ? vbe->bytes_per_scan_line : vbe->x_resolution * GRAPHICS_BYTES_PER_PIXEL;
+    uint32_t frame_bytes = line_bytes * vbe->y_resolution;
+
+    // A second page below the visible one turns presenting into a single register write
+    g_graphics_context.page_flipping = bochs_vbe_detect() && bochs_vbe_set_virtual_pages(vbe->y_resolution, 2);
+
+    // Let the CPU combine framebuffer stores into bursts. Reads from it bypass the cache and are
+    // slow: with page flipping, repairing the back page, blit_alpha and get_pixel on the back
+    // buffer all read video memory. Repairs copy only stale rectangles to keep that small.
+    paging_set_write_combining((void *)vbe->screen_ptr, g_graphics_context.page_flipping ? frame_bytes * 2 : frame_bytes);
+
     // Create front buffer (maps to hardware framebuffer)
     g_graphics_context.front_buffer = graphics_create_surface(vbe->x_resolution, vbe->y_resolution);
     if (g_graphics_context.front_buffer)
@@ -104,16 +259,24 @@ void _graphics_init_surfaces(void)
         g_graphics_context.front_buffer->pitch = vbe->x_resolution * GRAPHICS_BYTES_PER_PIXEL;
     }
 
-    // Create back buffer (in system memory for double buffering)
+    // Create back buffer, the hidden video memory page when flipping, system memory otherwise
     g_graphics_context.back_buffer = graphics_create_surface(vbe->x_resolution, vbe->y_resolution);
     if (g_graphics_context.back_buffer)
     {
         size_t buffer_size = vbe->x_resolution * vbe->y_resolution * sizeof(uint16_t);
-        g_graphics_context.back_buffer->pixels = (uint16_t *)kmalloc(buffer_size);
+        if (g_graphics_context.page_flipping)
+        {
+            g_graphics_context.back_buffer->pixels = (uint16_t *)(vbe->screen_ptr + frame_bytes);
+            g_graphics_context.back_page = 1;
+        }
+        else
+        {
+            g_graphics_context.back_buffer->pixels = (uint16_t *)kmalloc(buffer_size);
+        }
         g_graphics_context.back_buffer->pitch = vbe->x_resolution * GRAPHICS_BYTES_PER_PIXEL;
 
         // Clear back buffer to black
-        memset(g_graphics_context.back_buffer->pixels, 0, buffer_size);
+        memset16_stream(g_graphics_context.back_buffer->pixels, COLOR_BLACK, buffer_size / sizeof(uint16_t));
     }
 
     // Set global clipping rectangle
@@ -139,17 +302,11 @@ bool graphics_initialize(void)
 
     _graphics_init_surfaces();
 
-    if (!g_graphics_context.front_buffer || !g_graphics_context.back_buffer)
+    if (!g_graphics_context.front_buffer || !g_graphics_context.back_buffer || !g_graphics_context.back_buffer->pixels)
     {
         return false;
     }
 
-    // Initialize PIT timer for accurate FPS measurement
-    _graphics_init_pit_timer();
-
-    // Register PIT interrupt handler (IRQ 0 = interrupt 32)
-    idt_register_interrupt_callback(32, graphics_pit_interrupt_handler);
-
     g_graphics_context.double_buffering_enabled = true;
     g_graphics_context.vsync_enabled = true;
     g_graphics_context.initialized = true;
@@ -163,6 +320,8 @@ bool graphics_initialize(void)
     g_graphics_context.fps_limit_enabled = false;
     g_graphics_context.target_frame_time_ms = 0;
 
+    cursor_init();
+
     g_graphics_initialized = true;
     return true;
 }
@@ -172,7 +331,12 @@ void graphics_shutdown(void)
     if (!g_graphics_initialized)
         return;
 
-    if (g_graphics_context.back_buffer && g_graphics_context.back_buffer->pixels)
+    if (g_graphics_context.page_flipping)
+    {
+        // Leave the first page on screen for whoever draws to the framebuffer next
+        bochs_vbe_set_y_offset(0);
+    }
+    else if (g_graphics_context.back_buffer && g_graphics_context.back_buffer->pixels)
     {
         kfree(g_graphics_context.back_buffer->pixels);
     }
@@ -213,7 +377,7 @@ void graphics_begin_frame(void)
         return;
 
     g_graphics_context.in_frame = true;
-    g_frame_time_start = _graphics_get_time_ms();
+    g_frame_time_start = ktime_ns();
 }
 
 void graphics_end_frame(void)
@@ -221,11 +385,11 @@ void graphics_end_frame(void)
     if (!g_graphics_initialized || !g_graphics_context.in_frame)
         return;
 
-    uint32_t frame_time = _graphics_get_time_ms() - g_frame_time_start;
-    g_total_render_time += frame_time;
+    uint64_t frame_time_ns = ktime_ns() - g_frame_time_start;
+    g_total_render_time += frame_time_ns;
     g_frames_rendered++;
 
-    g_graphics_context.render_time_us = frame_time * 1000;
+    g_graphics_context.render_time_us = (uint32_t)div_u64(frame_time_ns, KTIME_NS_PER_US);
     g_graphics_context.frame_count++;
     g_graphics_context.in_frame = false;
 
@@ -242,6 +406,8 @@ void graphics_present(void)
         graphics_swap_buffers();
     }
 
+    vclock_frame_presented();
+
     if (g_graphics_context.vsync_enabled)
     {
         graphics_wait_vsync();
@@ -281,6 +447,60 @@ void graphics_wait_vsync(void)
     g_graphics_context.last_vsync_time = last_frame_time;
 }
 
+static void _graphics_flip_pages(void)
+{
+    GraphicsContext *ctx = &g_graphics_context;
+
+    bochs_vbe_set_y_offset(ctx->back_page * ctx->current_mode.height);
+
+    // The old page stays on screen until the next refresh. Rather than wait for it here,
+    // _graphics_finish_flip waits only if the page is drawn into before then
+    ctx->flip_pending = true;
+    ctx->flip_time_ns = ktime_ns();
+
+    uint16_t *shown = ctx->back_buffer->pixels;
+    ctx->back_buffer->pixels = ctx->front_buffer->pixels;
+    ctx->front_buffer->pixels = shown;
+    ctx->back_page ^= 1;
+
+    // The new back page lacks exactly what this frame drew
+    ctx->stale_full = ctx->needs_full_refresh;
+    ctx->stale_count = ctx->damage_count;
+    for (int i = 0; i < ctx->damage_count; i++)
+    {
+        ctx->stale[i] = ctx->damage[i];
+    }
+
+    ctx->damage_count = 0;
+    ctx->needs_full_refresh = false;
+    ctx->buffer_swap_pending = false;
+}
+
+// Copies what was drawn since the last present from the back buffer into the framebuffer
+static void _graphics_copy_damage(void)
+{
+    uint16_t *front_pixels = g_graphics_context.front_buffer->pixels;
+    uint16_t *back_pixels = g_graphics_context.back_buffer->pixels;
+    int width = g_graphics_context.current_mode.width;
+
+    if (g_graphics_context.needs_full_refresh)
+    {
+        memcpy_stream(front_pixels, back_pixels, width * g_graphics_context.current_mode.height * GRAPHICS_BYTES_PER_PIXEL);
+    }
+    else
+    {
+        // Only the damaged spans of each row reach the framebuffer
+        for (int i = 0; i < g_graphics_context.damage_count; i++)
+        {
+            _graphics_copy_rect(g_graphics_context.front_buffer, g_graphics_context.back_buffer, g_graphics_context.damage[i]);
+        }
+    }
+
+    g_graphics_context.damage_count = 0;
+    g_graphics_context.needs_full_refresh = false;
+    g_graphics_context.buffer_swap_pending = false;
+}
+
 void graphics_swap_buffers(void)
 {
     if (!g_graphics_initialized || !g_graphics_context.double_buffering_enabled)
@@ -288,19 +508,43 @@ void graphics_swap_buffers(void)
     if (!g_graphics_context.front_buffer || !g_graphics_context.back_buffer)
         return;
 
-    // High-performance buffer copy with memory optimization
-    uint16_t *front_pixels = g_graphics_context.front_buffer->pixels;
-    uint16_t *back_pixels = g_graphics_context.back_buffer->pixels;
+    // Nothing was drawn, the front buffer and the cursor over it stay as they are
+    if (!g_graphics_context.needs_full_refresh && g_graphics_context.damage_count == 0)
+        return;
 
-    int total_pixels = g_graphics_context.current_mode.width * g_graphics_context.current_mode.height;
+    cursor_present_begin();
+    if (g_graphics_context.page_flipping)
+        _graphics_flip_pages();
+    else
+        _graphics_copy_damage();
+    cursor_present_end();
+}
 
-    // Optimized memory copy (could use DMA in real hardware)
-    for (int i = 0; i < total_pixels; i++)
-    {
-        front_pixels[i] = back_pixels[i];
-    }
+void graphics_add_damage(Rectangle rect)
+{
+    if (!g_graphics_initialized)
+        return;
 
-    g_graphics_context.buffer_swap_pending = false;
+    _graphics_damage_surface(g_graphics_context.back_buffer, rect.x, rect.y, rect.width, rect.height);
+}
+
+void graphics_invalidate(void)
+{
+    if (!g_graphics_initialized)
+        return;
+
+    // Callers overwrite the whole back buffer next
+    _graphics_finish_flip();
+
+    g_graphics_context.needs_full_refresh = true;
+    g_graphics_context.damage_count = 0;
+
+    // The whole back buffer is about to be redrawn, whatever it missed no longer matters
+    g_graphics_context.stale_full = false;
+    g_graphics_context.stale_count = 0;
+
+    // Windows are composited into the back buffer too, a full redraw wipes them
+    compositor_expose_windows();
 }
 
 // =================== SURFACE MANAGEMENT ===================
@@ -323,6 +567,9 @@ GraphicsSurface *graphics_create_surface(int width, int height)
     surface->clip_rect.width = width;
     surface->clip_rect.height = height;
 
+    surface->track_damage = false;
+    surface->damage = (Rectangle){0, 0, 0, 0};
+
     surface->pixels = NULL; // Caller manages pixel memory
 
     return surface;
@@ -361,28 +608,18 @@ void graphics_clear_surface(GraphicsSurface *surface, Color color)
     int total_pixels = surface->width * surface->height;
     uint16_t *pixels = surface->pixels;
 
-    // Optimized clear using 32-bit writes when possible
-    if (total_pixels % 2 == 0 && ((uintptr_t)pixels & 3) == 0)
-    {
-        uint32_t double_color = (color << 16) | color;
-        uint32_t *pixels32 = (uint32_t *)pixels;
-        for (int i = 0; i < total_pixels / 2; i++)
-        {
-            pixels32[i] = double_color;
-        }
-    }
+    if (surface == g_graphics_context.back_buffer)
+        graphics_invalidate();
     else
-    {
-        for (int i = 0; i < total_pixels; i++)
-        {
-            pixels[i] = color;
-        }
-    }
+        _graphics_damage_surface(surface, 0, 0, surface->width, surface->height);
+
+    memset16_stream(pixels, color, total_pixels);
 }
 
 // =================== DRAWING PRIMITIVES ===================
 
-void graphics_set_pixel(GraphicsSurface *surface, int x, int y, Color color)
+// Writes a pixel without recording damage, callers damage the bounds of what they draw
+static void _graphics_plot(GraphicsSurface *surface, int x, int y, Color color)
 {
     if (!surface || !surface->pixels)
         return;
@@ -396,6 +633,12 @@ void graphics_set_pixel(GraphicsSurface *surface, int x, int y, Color color)
     surface->pixels[y * surface->width + x] = color;
 }
 
+void graphics_set_pixel(GraphicsSurface *surface, int x, int y, Color color)
+{
+    _graphics_damage_surface(surface, x, y, 1, 1);
+    _graphics_plot(surface, x, y, color);
+}
+
 Color graphics_get_pixel(GraphicsSurface *surface, int x, int y)
 {
     if (!surface || !surface->pixels)
@@ -406,24 +649,184 @@ Color graphics_get_pixel(GraphicsSurface *surface, int x, int y)
     return surface->pixels[y * surface->width + x];
 }
 
+// Cohen-Sutherland outcodes against the visible bounds
+#define GRAPHICS_CLIP_LEFT 1
+#define GRAPHICS_CLIP_RIGHT 2
+#define GRAPHICS_CLIP_TOP 4
+#define GRAPHICS_CLIP_BOTTOM 8
+
+// Past this the clip intersection products no longer fit in an int
+#define GRAPHICS_CLIP_COORD_LIMIT 16383
+
+// Visible pixels of a surface as an inclusive box, its clip rectangle limited to the surface
+static bool _graphics_visible_bounds(GraphicsSurface *surface, int *x1, int *y1, int *x2, int *y2)
+{
+    Rectangle clip = surface->clip_rect;
+    *x1 = clip.x < 0 ? 0 : clip.x;
+    *y1 = clip.y < 0 ? 0 : clip.y;
+    *x2 = clip.x + clip.width > surface->width ? surface->width - 1 : clip.x + clip.width - 1;
+    *y2 = clip.y + clip.height > surface->height ? surface->height - 1 : clip.y + clip.height - 1;
+    return *x1 <= *x2 && *y1 <= *y2;
+}
+
+// Horizontal run from x1 to x2 inclusive, clipped once then filled in one go
+static void _graphics_hspan(GraphicsSurface *surface, int x1, int x2, int y, Color color)
+{
+    int bx1, by1, bx2, by2;
+    if (!_graphics_visible_bounds(surface, &bx1, &by1, &bx2, &by2))
+        return;
+    if (y < by1 || y > by2)
+        return;
+
+    if (x1 < bx1)
+        x1 = bx1;
+    if (x2 > bx2)
+        x2 = bx2;
+    if (x1 > x2)
+        return;
+
+    memset16(&surface->pixels[y * surface->width + x1], color, x2 - x1 + 1);
+}
+
+static void _graphics_vspan(GraphicsSurface *surface, int x, int y1, int y2, Color color)
+{
+    int bx1, by1, bx2, by2;
+    if (!_graphics_visible_bounds(surface, &bx1, &by1, &bx2, &by2))
+        return;
+    if (x < bx1 || x > bx2)
+        return;
+
+    if (y1 < by1)
+        y1 = by1;
+    if (y2 > by2)
+        y2 = by2;
+
+    uint16_t *pixel = &surface->pixels[y1 * surface->width + x];
+    for (int y = y1; y <= y2; y++)
+    {
+        *pixel = color;
+        pixel += surface->width;
+    }
+}
+
+static int _graphics_outcode(int x, int y, int xmin, int ymin, int xmax, int ymax)
+{
+    int code = 0;
+    if (x < xmin)
+        code |= GRAPHICS_CLIP_LEFT;
+    else if (x > xmax)
+        code |= GRAPHICS_CLIP_RIGHT;
+    if (y < ymin)
+        code |= GRAPHICS_CLIP_TOP;
+    else if (y > ymax)
+        code |= GRAPHICS_CLIP_BOTTOM;
+    return code;
+}
+
+// Trims both endpoints onto the box, false when the line misses it entirely
+static bool _graphics_clip_line(Point *a, Point *b, int xmin, int ymin, int xmax, int ymax)
+{
+    int code_a = _graphics_outcode(a->x, a->y, xmin, ymin, xmax, ymax);
+    int code_b = _graphics_outcode(b->x, b->y, xmin, ymin, xmax, ymax);
+
+    while (true)
+    {
+        if (!(code_a | code_b))
+            return true;
+        if (code_a & code_b)
+            return false;
+
+        int out = code_a ? code_a : code_b;
+        int x, y;
+        if (out & GRAPHICS_CLIP_TOP)
+        {
+            x = a->x + (b->x - a->x) * (ymin - a->y) / (b->y - a->y);
+            y = ymin;
+        }
+        else if (out & GRAPHICS_CLIP_BOTTOM)
+        {
+            x = a->x + (b->x - a->x) * (ymax - a->y) / (b->y - a->y);
+            y = ymax;
+        }
+        else if (out & GRAPHICS_CLIP_RIGHT)
+        {
+            y = a->y + (b->y - a->y) * (xmax - a->x) / (b->x - a->x);
+            x = xmax;
+        }
+        else
+        {
+            y = a->y + (b->y - a->y) * (xmin - a->x) / (b->x - a->x);
+            x = xmin;
+        }
+
+        if (out == code_a)
+        {
+            a->x = x;
+            a->y = y;
+            code_a = _graphics_outcode(x, y, xmin, ymin, xmax, ymax);
+        }
+        else
+        {
+            b->x = x;
+            b->y = y;
+            code_b = _graphics_outcode(x, y, xmin, ymin, xmax, ymax);
+        }
+    }
+}
+
+static bool _graphics_coord_clippable(Point point)
+{
+    return point.x >= -GRAPHICS_CLIP_COORD_LIMIT && point.x <= GRAPHICS_CLIP_COORD_LIMIT &&
+           point.y >= -GRAPHICS_CLIP_COORD_LIMIT && point.y <= GRAPHICS_CLIP_COORD_LIMIT;
+}
+
 void graphics_draw_line(GraphicsSurface *surface, Point start, Point end, Color color)
 {
-    if (!surface)
+    if (!surface || !surface->pixels)
         return;
 
-    // Bresenham's line algorithm - optimized version
     int dx = abs(end.x - start.x);
     int dy = abs(end.y - start.y);
+    _graphics_damage_surface(surface, start.x < end.x ? start.x : end.x, start.y < end.y ? start.y : end.y, dx + 1, dy + 1);
+
+    // Axis aligned lines are plain spans
+    if (start.y == end.y)
+    {
+        _graphics_hspan(surface, start.x < end.x ? start.x : end.x, start.x < end.x ? end.x : start.x, start.y, color);
+        return;
+    }
+    if (start.x == end.x)
+    {
+        _graphics_vspan(surface, start.x, start.y < end.y ? start.y : end.y, start.y < end.y ? end.y : start.y, color);
+        return;
+    }
+
+    int xmin, ymin, xmax, ymax;
+    if (!_graphics_visible_bounds(surface, &xmin, &ymin, &xmax, &ymax))
+        return;
+
+    bool clipped = _graphics_coord_clippable(start) && _graphics_coord_clippable(end);
+    if (clipped && !_graphics_clip_line(&start, &end, xmin, ymin, xmax, ymax))
+        return;
+
+    // Bresenham's line algorithm
+    dx = abs(end.x - start.x);
+    dy = abs(end.y - start.y);
     int sx = start.x < end.x ? 1 : -1;
     int sy = start.y < end.y ? 1 : -1;
     int err = dx - dy;
 
     int x = start.x;
     int y = start.y;
+    uint16_t *pixel = &surface->pixels[y * surface->width + x];
 
     while (true)
     {
-        graphics_set_pixel(surface, x, y, color);
+        // Both endpoints are inside the bounds once clipped, so is everything between them
+        if (clipped)
+            *pixel = color;
+        else
+            _graphics_plot(surface, x, y, color);
 
         if (x == end.x && y == end.y)
             break;
@@ -433,30 +836,38 @@ void graphics_draw_line(GraphicsSurface *surface, Point start, Point end, Color
         {
             err -= dy;
             x += sx;
+            pixel += sx;
         }
         if (e2 < dx)
         {
             err += dx;
             y += sy;
+            pixel += sy * surface->width;
         }
     }
 }
 
 void graphics_draw_rect(GraphicsSurface *surface, Rectangle rect, Color color)
 {
-    if (!surface)
+    if (!surface || !surface->pixels || rect.width <= 0 || rect.height <= 0)
         return;
 
-    // Draw rectangle outline - optimized
-    Point top_left = {rect.x, rect.y};
-    Point top_right = {rect.x + rect.width - 1, rect.y};
-    Point bottom_left = {rect.x, rect.y + rect.height - 1};
-    Point bottom_right = {rect.x + rect.width - 1, rect.y + rect.height - 1};
+    int right = rect.x + rect.width - 1;
+    int bottom = rect.y + rect.height - 1;
 
-    graphics_draw_line(surface, top_left, top_right, color);       // Top
-    graphics_draw_line(surface, top_right, bottom_right, color);   // Right
-    graphics_draw_line(surface, bottom_right, bottom_left, color); // Bottom
-    graphics_draw_line(surface, bottom_left, top_left, color);     // Left
+    _graphics_damage_surface(surface, rect.x, rect.y, rect.width, 1);
+    _graphics_damage_surface(surface, rect.x, bottom, rect.width, 1);
+    _graphics_damage_surface(surface, rect.x, rect.y, 1, rect.height);
+    _graphics_damage_surface(surface, right, rect.y, 1, rect.height);
+
+    // Rows for the top and bottom edges, columns for the sides in between
+    _graphics_hspan(surface, rect.x, right, rect.y, color);
+    _graphics_hspan(surface, rect.x, right, bottom, color);
+    if (rect.height > 2)
+    {
+        _graphics_vspan(surface, rect.x, rect.y + 1, bottom - 1, color);
+        _graphics_vspan(surface, right, rect.y + 1, bottom - 1, color);
+    }
 }
 
 void graphics_fill_rect(GraphicsSurface *surface, Rectangle rect, Color color)
@@ -469,39 +880,63 @@ void graphics_fill_rect(GraphicsSurface *surface, Rectangle rect, Color color)
     int y1 = rect.y < 0 ? 0 : rect.y;
     int x2 = rect.x + rect.width > surface->width ? surface->width : rect.x + rect.width;
     int y2 = rect.y + rect.height > surface->height ? surface->height : rect.y + rect.height;
+    if (x1 >= x2 || y1 >= y2)
+        return;
+
+    _graphics_damage_surface(surface, x1, y1, x2 - x1, y2 - y1);
 
-    // Optimized filled rectangle
     for (int y = y1; y < y2; y++)
     {
-        uint16_t *row = &surface->pixels[y * surface->width + x1];
-        for (int x = x1; x < x2; x++)
-        {
-            *row++ = color;
-        }
+        memset16(&surface->pixels[y * surface->width + x1], color, x2 - x1);
     }
 }
 
 void graphics_draw_circle(GraphicsSurface *surface, Point center, int radius, Color color)
 {
-    if (!surface)
+    if (!surface || !surface->pixels || radius < 0)
         return;
 
-    // Midpoint circle algorithm - optimized
+    _graphics_damage_surface(surface, center.x - radius, center.y - radius, radius * 2 + 1, radius * 2 + 1);
+
+    // Fully visible circles skip the per pixel checks
+    int xmin, ymin, xmax, ymax;
+    if (!_graphics_visible_bounds(surface, &xmin, &ymin, &xmax, &ymax))
+        return;
+    bool inside = center.x - radius >= xmin && center.x + radius <= xmax &&
+                  center.y - radius >= ymin && center.y + radius <= ymax;
+    uint16_t *pixels = surface->pixels;
+    int width = surface->width;
+
+    // Midpoint circle algorithm
     int x = 0;
     int y = radius;
     int d = 3 - 2 * radius;
 
     while (y >= x)
     {
-        // Draw 8 octants efficiently
-        graphics_set_pixel(surface, center.x + x, center.y + y, color);
-        graphics_set_pixel(surface, center.x - x, center.y + y, color);
-        graphics_set_pixel(surface, center.x + x, center.y - y, color);
-        graphics_set_pixel(surface, center.x - x, center.y - y, color);
-        graphics_set_pixel(surface, center.x + y, center.y + x, color);
-        graphics_set_pixel(surface, center.x - y, center.y + x, color);
-        graphics_set_pixel(surface, center.x + y, center.y - x, color);
-        graphics_set_pixel(surface, center.x - y, center.y - x, color);
+        if (inside)
+        {
+            // Eight octants, mirrored around the centre
+            pixels[(center.y + y) * width + center.x + x] = color;
+            pixels[(center.y + y) * width + center.x - x] = color;
+            pixels[(center.y - y) * width + center.x + x] = color;
+            pixels[(center.y - y) * width + center.x - x] = color;
+            pixels[(center.y + x) * width + center.x + y] = color;
+            pixels[(center.y + x) * width + center.x - y] = color;
+            pixels[(center.y - x) * width + center.x + y] = color;
+            pixels[(center.y - x) * width + center.x - y] = color;
+        }
+        else
+        {
+            _graphics_plot(surface, center.x + x, center.y + y, color);
+            _graphics_plot(surface, center.x - x, center.y + y, color);
+            _graphics_plot(surface, center.x + x, center.y - y, color);
+            _graphics_plot(surface, center.x - x, center.y - y, color);
+            _graphics_plot(surface, center.x + y, center.y + x, color);
+            _graphics_plot(surface, center.x - y, center.y + x, color);
+            _graphics_plot(surface, center.x + y, center.y - x, color);
+            _graphics_plot(surface, center.x - y, center.y - x, color);
+        }
 
         x++;
         if (d > 0)
@@ -518,17 +953,23 @@ void graphics_draw_circle(GraphicsSurface *surface, Point center, int radius, Co
 
 void graphics_fill_circle(GraphicsSurface *surface, Point center, int radius, Color color)
 {
-    if (!surface)
+    if (!surface || !surface->pixels || radius < 0)
         return;
 
-    // Optimized filled circle using scanlines
-    for (int y = -radius; y <= radius; y++)
+    _graphics_damage_surface(surface, center.x - radius, center.y - radius, radius * 2 + 1, radius * 2 + 1);
+
+    // Widest extent with extent^2 + dy^2 <= radius^2 only shrinks as dy grows, so it is
+    // found incrementally with integers and each row is a single span
+    int extent = radius;
+    int radius_squared = radius * radius;
+    for (int dy = 0; dy <= radius; dy++)
     {
-        int x_extent = (int)fpu_sqrt((double)(radius * radius - y * y));
-        for (int x = -x_extent; x <= x_extent; x++)
-        {
-            graphics_set_pixel(surface, center.x + x, center.y + y, color);
-        }
+        while (extent * extent + dy * dy > radius_squared)
+            extent--;
+
+        _graphics_hspan(surface, center.x - extent, center.x + extent, center.y + dy, color);
+        if (dy)
+            _graphics_hspan(surface, center.x - extent, center.x + extent, center.y - dy, color);
     }
 }
 
@@ -547,21 +988,40 @@ void graphics_blit_surface(GraphicsSurface *dest, GraphicsSurface *src, Rectangl
     int src_x_end = source.x + source.width > src->width ? src->width : source.x + source.width;
     int src_y_end = source.y + source.height > src->height ? src->height : source.y + source.height;
 
-    for (int src_y = src_y_start; src_y < src_y_end; src_y++)
+    // Clip against the destination's clip rectangle too, then every row is one straight copy
+    int xmin, ymin, xmax, ymax;
+    if (!_graphics_visible_bounds(dest, &xmin, &ymin, &xmax, &ymax))
+        return;
+
+    int dst_x = dest_point.x + (src_x_start - source.x);
+    int dst_y = dest_point.y + (src_y_start - source.y);
+    if (dst_x < xmin)
     {
-        int dst_y = dest_point.y + (src_y - source.y);
-        if (dst_y < 0 || dst_y >= dest->height)
-            continue;
+        src_x_start += xmin - dst_x;
+        dst_x = xmin;
+    }
+    if (dst_y < ymin)
+    {
+        src_y_start += ymin - dst_y;
+        dst_y = ymin;
+    }
+    if (dst_x + (src_x_end - src_x_start) > xmax + 1)
+        src_x_end = src_x_start + xmax + 1 - dst_x;
+    if (dst_y + (src_y_end - src_y_start) > ymax + 1)
+        src_y_end = src_y_start + ymax + 1 - dst_y;
+    if (src_x_start >= src_x_end || src_y_start >= src_y_end)
+        return;
 
-        for (int src_x = src_x_start; src_x < src_x_end; src_x++)
-        {
-            int dst_x = dest_point.x + (src_x - source.x);
-            if (dst_x < 0 || dst_x >= dest->width)
-                continue;
+    int width = src_x_end - src_x_start;
+    _graphics_damage_surface(dest, dst_x, dst_y, width, src_y_end - src_y_start);
 
-            Color pixel = src->pixels[src_y * src->width + src_x];
-            dest->pixels[dst_y * dest->width + dst_x] = pixel;
-        }
+    uint16_t *dst_row = &dest->pixels[dst_y * dest->width + dst_x];
+    const uint16_t *src_row = &src->pixels[src_y_start * src->width + src_x_start];
+    for (int src_y = src_y_start; src_y < src_y_end; src_y++)
+    {
+        memcpy(dst_row, (void *)src_row, width * sizeof(uint16_t));
+        dst_row += dest->width;
+        src_row += src->width;
     }
 }
 
@@ -570,27 +1030,35 @@ void graphics_blit_scaled(GraphicsSurface *dest, GraphicsSurface *src, Rectangle
     if (!dest || !src || !dest->pixels || !src->pixels || !dest_rect)
         return;
 
+    if (dest_rect->width <= 0 || dest_rect->height <= 0)
+        return;
+
     Rectangle source = src_rect ? *src_rect : (Rectangle){0, 0, src->width, src->height};
+    if (source.width <= 0 || source.height <= 0)
+        return;
 
-    // Bilinear scaling algorithm
-    double x_scale = (double)source.width / dest_rect->width;
-    double y_scale = (double)source.height / dest_rect->height;
+    // Nearest neighbour with 16.16 fixed point steps, the kernel doesn't own the FPU here
+    uint32_t x_step = ((uint32_t)source.width << 16) / dest_rect->width;
+    uint32_t y_step = ((uint32_t)source.height << 16) / dest_rect->height;
 
-    for (int dst_y = 0; dst_y < dest_rect->height; dst_y++)
+    _graphics_damage_surface(dest, dest_rect->x, dest_rect->y, dest_rect->width, dest_rect->height);
+
+    uint32_t y_fixed = 0;
+    for (int dst_y = 0; dst_y < dest_rect->height; dst_y++, y_fixed += y_step)
     {
         int screen_y = dest_rect->y + dst_y;
         if (screen_y < 0 || screen_y >= dest->height)
             continue;
 
-        for (int dst_x = 0; dst_x < dest_rect->width; dst_x++)
+        int src_y = source.y + (int)(y_fixed >> 16);
+        uint32_t x_fixed = 0;
+        for (int dst_x = 0; dst_x < dest_rect->width; dst_x++, x_fixed += x_step)
         {
             int screen_x = dest_rect->x + dst_x;
             if (screen_x < 0 || screen_x >= dest->width)
                 continue;
 
-            int src_x = (int)(source.x + dst_x * x_scale);
-            int src_y = (int)(source.y + dst_y * y_scale);
-
+            int src_x = source.x + (int)(x_fixed >> 16);
             if (src_x >= 0 && src_x < src->width && src_y >= 0 && src_y < src->height)
             {
                 Color pixel = src->pixels[src_y * src->width + src_x];
@@ -607,6 +1075,8 @@ void graphics_blit_alpha(GraphicsSurface *dest, GraphicsSurface *src, Rectangle
 
     Rectangle source = src_rect ? *src_rect : (Rectangle){0, 0, src->width, src->height};
 
+    _graphics_damage_surface(dest, dest_point.x, dest_point.y, source.width, source.height);
+
     for (int y = 0; y < source.height; y++)
     {
         for (int x = 0; x < source.width; x++)
@@ -719,11 +1189,67 @@ void graphics_draw_text(GraphicsSurface *surface, const char *text, Point positi
     graphics_draw_text_scaled(surface, text, position, color, 1);
 }
 
+// Slow path for scales without an atlas, looks the font up per row and plots every pixel
+static void _graphics_draw_glyph_direct(GraphicsSurface *surface, char c, int x, int y, Color color, int scale)
+{
+    for (int char_y = 0; char_y < FONT_ATARIST8X16SYSTEMFONT_HEIGHT; char_y++)
+    {
+        unsigned int char_row = getAtariST8x16SystemFontCharacter(c, char_y);
+
+        for (int char_x = 0; char_x < FONT_ATARIST8X16SYSTEMFONT_WIDTH; char_x++)
+        {
+            if (char_row & (1 << (FONT_ATARIST8X16SYSTEMFONT_WIDTH - 1 - char_x)))
+            {
+                // Draw scaled pixel block
+                for (int sy = 0; sy < scale; sy++)
+                {
+                    for (int sx = 0; sx < scale; sx++)
+                    {
+                        int pixel_x = x + char_x * scale + sx;
+                        int pixel_y = y + char_y * scale + sy;
+                        _graphics_plot(surface, pixel_x, pixel_y, color);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Clips the glyph box once, then walks whole mask rows without per pixel checks
+static void _graphics_blit_glyph(GraphicsSurface *surface, const struct glyph_atlas *atlas, const uint16_t *mask, int x, int y, Color color)
+{
+    int bx1, by1, bx2, by2;
+    if (!_graphics_visible_bounds(surface, &bx1, &by1, &bx2, &by2))
+        return;
+
+    int x1 = x < bx1 ? bx1 : x;
+    int y1 = y < by1 ? by1 : y;
+    int x2 = x + atlas->glyph_width - 1 > bx2 ? bx2 : x + atlas->glyph_width - 1;
+    int y2 = y + atlas->glyph_height - 1 > by2 ? by2 : y + atlas->glyph_height - 1;
+    if (x1 > x2 || y1 > y2)
+        return;
+
+    int span = x2 - x1 + 1;
+    for (int row = y1; row <= y2; row++)
+    {
+        const uint16_t *src = &mask[(row - y) * atlas->glyph_width + (x1 - x)];
+        uint16_t *dst = &surface->pixels[row * surface->width + x1];
+
+        // Only lit pixels are written, the back buffer may be write-combined video memory
+        for (int i = 0; i < span; i++)
+        {
+            if (src[i])
+                dst[i] = color;
+        }
+    }
+}
+
 void graphics_draw_text_scaled(GraphicsSurface *surface, const char *text, Point position, Color color, int scale)
 {
-    if (!surface || !text || scale < 1)
+    if (!surface || !surface->pixels || !text || scale < 1)
         return;
 
+    const struct glyph_atlas *atlas = glyph_cache_get(scale);
     int x = position.x;
     int y = position.y;
 
@@ -740,27 +1266,17 @@ void graphics_draw_text_scaled(GraphicsSurface *surface, const char *text, Point
         }
         else
         {
-            // Render character with high-quality scaling
-            for (int char_y = 0; char_y < FONT_ATARIST8X16SYSTEMFONT_HEIGHT; char_y++)
-            {
-                unsigned int char_row = getAtariST8x16SystemFontCharacter(*text, char_y);
+            _graphics_damage_surface(surface, x, y, FONT_ATARIST8X16SYSTEMFONT_WIDTH * scale, FONT_ATARIST8X16SYSTEMFONT_HEIGHT * scale);
 
-                for (int char_x = 0; char_x < FONT_ATARIST8X16SYSTEMFONT_WIDTH; char_x++)
-                {
-                    if (char_row & (1 << (FONT_ATARIST8X16SYSTEMFONT_WIDTH - 1 - char_x)))
-                    {
-                        // Draw scaled pixel block
-                        for (int sy = 0; sy < scale; sy++)
-                        {
-                            for (int sx = 0; sx < scale; sx++)
-                            {
-                                int pixel_x = x + char_x * scale + sx;
-                                int pixel_y = y + char_y * scale + sy;
-                                graphics_set_pixel(surface, pixel_x, pixel_y, color);
-                            }
-                        }
-                    }
-                }
+            if (atlas)
+            {
+                const uint16_t *mask = glyph_atlas_mask(atlas, *text);
+                if (mask)
+                    _graphics_blit_glyph(surface, atlas, mask, x, y, color);
+            }
+            else
+            {
+                _graphics_draw_glyph_direct(surface, *text, x, y, color, scale);
             }
             x += FONT_ATARIST8X16SYSTEMFONT_WIDTH * scale;
         }
@@ -935,37 +1451,10 @@ void DrawMouse(int x, int y, int r, int g, int b)
     if (!g_graphics_initialized)
         return;
 
-    Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsSurface *surface = g_graphics_context.double_buffering_enabled ? g_graphics_context.back_buffer : g_graphics_context.front_buffer;
-
-    // Professional mouse cursor with anti-aliasing
-    static int mouse_pattern[] = {
-        0b1111111111,
-        0b1111111110,
-        0b1111111100,
-        0b1111111000,
-        0b1111110000,
-        0b1111100000,
-        0b1111000000,
-        0b1110000000,
-        0b1100000000,
-        0b1000000000,
-    };
-
-    // Draw cursor with shadow for better visibility
-    for (int row = 0; row < 10; row++)
-    {
-        for (int col = 0; col < 10; col++)
-        {
-            if (mouse_pattern[row] & (1 << (9 - col)))
-            {
-                // Draw shadow (offset by 1,1)
-                graphics_set_pixel(surface, x + col + 1, y + row + 1, COLOR_BLACK);
-                // Draw cursor
-                graphics_set_pixel(surface, x + col, y + row, color);
-            }
-        }
-    }
+    // An overlay on the visible page, moving it leaves the back buffer and its damage alone
+    cursor_set_color(graphics_rgb_to_color(r, g, b));
+    cursor_move(x, y);
+    cursor_show(true);
 }
 
 void Flush(void)
@@ -992,15 +1481,3 @@ void DrawAtariChar(char c, int x, int y, int r, int g, int b, int scale)
     char str[2] = {c, '\0'};
     DrawAtariString(str, x, y, r, g, b, scale);
 }
-
-// PIT interrupt handler (IRQ 0)
-void graphics_pit_interrupt_handler(struct interrupt_frame *frame)
-{
-    _graphics_pit_tick();
-    simple_serial_puts("PIT tick\n");
-    char debug_str[64];
-    int_to_str((int)_graphics_get_time_ms(), debug_str);
-    simple_serial_puts("ms: ");
-    simple_serial_puts(debug_str);
-    simple_serial_puts("\n");
-}
@@ -54,6 +54,9 @@ typedef struct VBEInfoBlockStruct
 #define GRAPHICS_BPP 16
 #define GRAPHICS_BYTES_PER_PIXEL 2
 
+// Damage rectangles kept per frame before they are merged into the closest one
+#define GRAPHICS_MAX_DAMAGE_RECTS 16
+
 // Color format (RGB565)
 typedef uint16_t Color;
 #define COLOR_BLACK 0x0000
@@ -85,6 +88,10 @@ typedef struct GraphicsSurface
     Rectangle clip_rect; // Clipping rectangle
     bool is_locked;      // Surface lock state
     uint32_t format;     // Pixel format
+
+    // Bounding box of drawing since it was last reset, only kept when track_damage is set
+    bool track_damage;
+    Rectangle damage;
 } GraphicsSurface;
 
 // Display mode structure
@@ -130,10 +137,27 @@ typedef struct
     uint32_t last_fps_update;
     uint32_t render_time_us;
 
+    // Back buffer regions drawn since the last present, merged when they overlap or touch
+    Rectangle damage[GRAPHICS_MAX_DAMAGE_RECTS];
+    int damage_count;
+
+    // Page flipping on the Bochs/QEMU adapter, both buffers are then pages of video memory
+    bool page_flipping;
+    int back_page;
+
+    // What the back page missed while it was on screen, copied over before it is drawn into
+    Rectangle stale[GRAPHICS_MAX_DAMAGE_RECTS];
+    int stale_count;
+    bool stale_full;
+
+    // A flip the display may still not have picked up, the old page is drawn into only after it has
+    bool flip_pending;
+    uint64_t flip_time_ns;
+
     // State flags
     bool initialized;
     bool in_frame;
-    bool needs_full_refresh;
+    bool needs_full_refresh; // Next present copies the whole back buffer, ignoring damage
 
     // Hardware capabilities
     bool hardware_acceleration;
@@ -156,6 +180,11 @@ void graphics_present(void);
 void graphics_wait_vsync(void);
 void graphics_swap_buffers(void);
 
+// Damage tracking, drawing primitives on the back buffer record their own damage.
+// Code writing pixels directly reports the region before writing, page flips may repair it
+void graphics_add_damage(Rectangle rect);
+void graphics_invalidate(void);
+
 // Surface management
 GraphicsSurface *graphics_create_surface(int width, int height);
 void graphics_destroy_surface(GraphicsSurface *surface);
@@ -222,7 +251,7 @@ bool _graphics_init_framebuffer(void);
 void _graphics_init_surfaces(void);
 uint32_t _graphics_get_time_ms(void);
 bool _graphics_is_point_visible(GraphicsSurface *surface, Point point);
+void _graphics_damage_surface(GraphicsSurface *surface, int x, int y, int width, int height);
 void _graphics_update_fps_counter(void);
-void graphics_pit_interrupt_handler(struct interrupt_frame *frame);
 
 #endif // GRAPHICS_H
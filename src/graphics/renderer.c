@@ -101,9 +101,7 @@ void renderer_update_mouse(FrameState *state, struct mouse *mouse)
 {
     int x = mouse->x, y = mouse->y;
 
-    if (state->prev_mouse_x != -1 && state->prev_mouse_y != -1 && (x != state->prev_mouse_x || y != state->prev_mouse_y))
-        DrawRect(state->prev_mouse_x, state->prev_mouse_y, 12, 12, 11, 25, 69);
-
+    // The overlay puts back what was under the old position itself
     DrawMouse(x, y, 255, 255, 255);
 
     state->prev_mouse_x = x;
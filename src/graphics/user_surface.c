@@ -0,0 +1,74 @@
+#include "user_surface.h"
+#include "graphics.h"
+#include "compositor.h"
+#include "status.h"
+#include "task/process.h"
+#include "memory/shm/shm.h"
+
+int user_surface_create(struct process *process, int width, int height, void **virt_out)
+{
+    if (width <= 0 || height <= 0 || width > USER_SURFACE_MAX_SIDE || height > USER_SURFACE_MAX_SIDE)
+    {
+        return -EINVARG;
+    }
+
+    // A process has one surface, asking again resizes it
+    if (process->surface.virt)
+    {
+        shm_unmap(process, process->surface.virt);
+        process->surface.virt = 0;
+    }
+
+    void *virt = 0;
+    int res = shm_create(process, (uint32_t)width * height * sizeof(Color), 0, &virt);
+    if (res < 0)
+    {
+        return res;
+    }
+
+    process->surface.virt = virt;
+    process->surface.width = width;
+    process->surface.height = height;
+    *virt_out = virt;
+    return 0;
+}
+
+int user_surface_present(struct process *process, const struct user_surface_rect *rect, int dest_x, int dest_y)
+{
+    struct user_surface *surface = &process->surface;
+    if (!surface->virt)
+    {
+        return -EINVARG;
+    }
+
+    // The process may have unmapped the region itself, never read frames it no longer owns
+    uint16_t *pixels = shm_kernel_address(process, surface->virt, (uint32_t)surface->width * surface->height * sizeof(Color));
+    if (!pixels)
+    {
+        surface->virt = 0;
+        return -EINVARG;
+    }
+
+    GraphicsSurface *target = compositor_target(process);
+    if (!target)
+    {
+        return -EIO;
+    }
+
+    GraphicsSurface source = {
+        .pixels = pixels,
+        .width = surface->width,
+        .height = surface->height,
+        .pitch = surface->width * sizeof(Color),
+        .clip_rect = {0, 0, surface->width, surface->height},
+    };
+
+    Rectangle source_rect = {0, 0, surface->width, surface->height};
+    if (rect)
+    {
+        source_rect = (Rectangle){rect->x, rect->y, rect->width, rect->height};
+    }
+
+    graphics_blit_surface(target, &source, &source_rect, (Point){dest_x, dest_y});
+    return 0;
+}
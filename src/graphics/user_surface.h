@@ -0,0 +1,41 @@
+#ifndef USER_SURFACE_H
+#define USER_SURFACE_H
+
+#include <stdint.h>
+
+struct process;
+
+// Keeps width * height * 2 bytes well inside one shared memory region
+#define USER_SURFACE_MAX_SIDE 2048
+
+/**
+ * RGB565 drawing surface mapped into a process. The pixels are a shared memory region,
+ * so the process draws with plain stores and the kernel reads the same frames on present.
+ */
+struct user_surface
+{
+    void *virt;
+    int width;
+    int height;
+};
+
+// Part of a surface to present, also the layout user programs pass in
+struct user_surface_rect
+{
+    int x, y;
+    int width, height;
+};
+
+/**
+ * Maps a width x height surface into the process, replacing any surface it already had.
+ * Rows are width pixels apart. Returns 0 and stores the user address in virt_out.
+ */
+int user_surface_create(struct process *process, int width, int height, void **virt_out);
+
+/**
+ * Copies rect of the process' surface (all of it when rect is NULL) into its drawing target,
+ * see compositor_target, with its top left corner at dest_x, dest_y. Only the copied area is damaged.
+ */
+int user_surface_present(struct process *process, const struct user_surface_rect *rect, int dest_x, int dest_y);
+
+#endif
@@ -1,5 +1,6 @@
 #include "vix_kernel.h"
 #include "graphics.h" // Existing graphics functions
+#include "compositor.h"
 
 void vix_kernel_draw_pixel(int x, int y, uint32_t color) {
     Color c = graphics_rgb_to_color((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
@@ -36,7 +37,8 @@ void vix_kernel_clear_screen(uint32_t color) {
 }
 
 void vix_kernel_present_frame(void) {
-    graphics_present();
+    // Through the compositor so windows the kernel drew over are put back on top
+    compositor_present();
 }
 
 void vix_kernel_get_screen_info(struct vix_screen_info *info) {
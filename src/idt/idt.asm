@@ -9,6 +9,7 @@ global idt_load
 global no_interrupt
 global enable_interrupts
 global disable_interrupts
+global wait_for_interrupt
 global isr80h_wrapper
 global interrupt_pointer_table
 
@@ -20,6 +21,13 @@ disable_interrupts:
     cli
     ret
 
+; sti only takes effect after the next instruction, so an interrupt already pending wakes the hlt
+wait_for_interrupt:
+    sti
+    hlt
+    cli
+    ret
+
 
 idt_load:
     push ebp
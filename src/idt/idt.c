@@ -1,4 +1,6 @@
 #include "idt.h"
+#include "softirq.h"
+#include "irq/irq.h"
 #include "config.h"
 #include "panic/panic.h"
 #include "kernel.h"
@@ -6,10 +8,12 @@
 #include "task/task.h"
 #include "task/process.h"
 #include "io/io.h"
+#include "memory/paging/paging.h"
 #include "status.h"
 #include "mouse/mouse.h"       // Add mouse header
 #include "keyboard/keyboard.h" // Add keyboard header
 #include "debug/simple_serial.h"
+#include "isr80h/trace.h"
 
 struct idt_desc idt_descriptors[VIOS_TOTAL_INTERRUPTS];
 struct idtr_desc idtr_descriptor;
@@ -17,6 +21,7 @@ struct idtr_desc idtr_descriptor;
 extern void *interrupt_pointer_table[VIOS_TOTAL_INTERRUPTS];
 
 static INTERRUPT_CALLBACK_FUNCTION interrupt_callbacks[VIOS_TOTAL_INTERRUPTS];
+static INTERRUPT_FAST_CALLBACK interrupt_fast_callbacks[VIOS_TOTAL_INTERRUPTS];
 
 static ISR80H_COMMAND isr80h_commands[VIOS_MAX_ISR80H_COMMANDS];
 
@@ -34,29 +39,48 @@ void no_interrupt_handler()
 
 void interrupt_handler(int interrupt, struct interrupt_frame *frame)
 {
+    // Top half: runs in whatever address space was live, nothing is saved or switched
+    INTERRUPT_FAST_CALLBACK top_half = interrupt_fast_callbacks[interrupt];
+    int top_half_result = IDT_IRQ_SLOW_PATH;
+    if (top_half)
+    {
+        top_half_result = top_half(frame);
+    }
+
+    if (top_half_result == IDT_IRQ_HANDLED && !softirq_pending())
+    {
+        irq_end_of_interrupt(interrupt);
+        return;
+    }
+
+    // Kernel mode interrupts (e.g. the lazy FPU trap, or an IRQ during a system call)
+    // must not clobber the saved user registers or leave the kernel on the task's page tables
+    bool from_user = task_current() && (frame->cs & 0x03) == 0x03;
+    uint32_t *interrupted_directory = paging_current_directory();
+
     kernel_page();
-    if (interrupt_callbacks[interrupt] != 0)
+    if (top_half_result == IDT_IRQ_SLOW_PATH && interrupt_callbacks[interrupt] != 0)
     {
-        // Only save task state if there's a current task
-        if (task_current())
+        if (from_user)
         {
             task_current_save_state(frame);
         }
         interrupt_callbacks[interrupt](frame);
     }
 
-    // Only switch to task page if there's a current task
-    if (task_current())
+    // Deferred work runs with interrupts enabled, so the line has to be acknowledged first
+    irq_end_of_interrupt(interrupt);
+    softirq_run();
+
+    if (from_user)
     {
         task_page();
     }
-    
-    // Send EOI to appropriate PIC
-    if (interrupt >= 0x28) // Slave PIC interrupts (IRQ 8-15)
+    else if (interrupted_directory)
     {
-        outb(0xA0, 0x20); // Send EOI to slave PIC
+        // Kernel code may be mid copy through a task's page tables, resume it on the same ones
+        paging_restore_directory(interrupted_directory);
     }
-    outb(0x20, 0x20); // Always send EOI to master PIC
 }
 
 void idt_zero()
@@ -121,6 +145,17 @@ int idt_register_interrupt_callback(int interrupt, INTERRUPT_CALLBACK_FUNCTION i
     return 0;
 }
 
+int idt_register_fast_interrupt_callback(int interrupt, INTERRUPT_FAST_CALLBACK top_half)
+{
+    if (interrupt < 0 || interrupt >= VIOS_TOTAL_INTERRUPTS)
+    {
+        return -EINVARG;
+    }
+
+    interrupt_fast_callbacks[interrupt] = top_half;
+    return 0;
+}
+
 void isr80h_register_command(int command_id, ISR80H_COMMAND command)
 {
     if (command_id < 0 || command_id >= VIOS_MAX_ISR80H_COMMANDS)
@@ -152,7 +187,10 @@ void *isr80h_handle_command(int command, struct interrupt_frame *frame)
         return 0;
     }
 
+    // Handlers that switch away with task_next() never come back here and aren't counted
+    uint64_t start = isr80h_trace_begin();
     result = command_func(frame);
+    isr80h_trace_end(command, start);
     return result;
 }
 
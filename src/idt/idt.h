@@ -9,6 +9,16 @@ struct interrupt_frame;
 typedef void *(*ISR80H_COMMAND)(struct interrupt_frame *frame);
 typedef void (*INTERRUPT_CALLBACK_FUNCTION)(struct interrupt_frame *frame);
 
+/**
+ * A fast top half runs before any task state is saved or page directory switched, so it may
+ * only touch the kernel image and memory allocated at boot, never process memory. It returns
+ * IDT_IRQ_SLOW_PATH when the regular callback has to run, longer work should be handed to
+ * softirq_raise instead so it runs after the EOI with interrupts enabled.
+ */
+typedef int (*INTERRUPT_FAST_CALLBACK)(struct interrupt_frame *frame);
+#define IDT_IRQ_HANDLED 0
+#define IDT_IRQ_SLOW_PATH 1
+
 struct idt_desc
 {
     uint16_t offset_1; // Offset bits 0 - 15
@@ -44,7 +54,12 @@ struct interrupt_frame
 void idt_init();
 void enable_interrupts();
 void disable_interrupts();
+
+// Halts with interrupts enabled until one has been handled, returns with them disabled again
+void wait_for_interrupt();
 void isr80h_register_command(int command_id, ISR80H_COMMAND command);
+void *isr80h_handle_command(int command, struct interrupt_frame *frame);
 int idt_register_interrupt_callback(int interrupt, INTERRUPT_CALLBACK_FUNCTION interrupt_callback);
+int idt_register_fast_interrupt_callback(int interrupt, INTERRUPT_FAST_CALLBACK top_half);
 
 #endif
\ No newline at end of file
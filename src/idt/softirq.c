@@ -0,0 +1,92 @@
+#include "softirq.h"
+#include "idt.h"
+#include "cpu/cpu.h"
+#include "sync/percpu.h"
+
+// Work raised while draining is picked up again, but only this many times per call
+#define SOFTIRQ_MAX_RESTARTS 8
+
+// LIFO of raised work, pushed by top halves and swapped out whole by softirq_run
+static DEFINE_PER_CPU(struct softirq_work *, softirq_queue);
+static DEFINE_PER_CPU(bool, softirq_running);
+
+void softirq_work_init(struct softirq_work *work, SOFTIRQ_FUNCTION function, void *data)
+{
+    work->function = function;
+    work->data = data;
+    work->pending = 0;
+    work->next = 0;
+}
+
+bool softirq_raise(struct softirq_work *work)
+{
+    if (__atomic_exchange_n(&work->pending, 1, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    struct softirq_work **queue = &this_cpu(softirq_queue);
+    struct softirq_work *head = __atomic_load_n(queue, __ATOMIC_RELAXED);
+    do
+    {
+        work->next = head;
+    } while (!__atomic_compare_exchange_n(queue, &head, work, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    return true;
+}
+
+bool softirq_pending()
+{
+    return __atomic_load_n(&this_cpu(softirq_queue), __ATOMIC_RELAXED) != 0;
+}
+
+static void softirq_run_list(struct softirq_work *list)
+{
+    // The queue is a stack, reverse it so work runs in the order it was raised
+    struct softirq_work *ordered = 0;
+    while (list)
+    {
+        struct softirq_work *next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    while (ordered)
+    {
+        struct softirq_work *work = ordered;
+        ordered = work->next;
+
+        // Cleared first so the handler's own interrupt can raise it again while it runs
+        __atomic_store_n(&work->pending, 0, __ATOMIC_RELEASE);
+        work->function(work->data);
+    }
+}
+
+void softirq_run()
+{
+    uint32_t flags = cpu_irq_save();
+    int cpu = cpu_current_id();
+    if (per_cpu(softirq_running, cpu))
+    {
+        cpu_irq_restore(flags);
+        return;
+    }
+
+    per_cpu(softirq_running, cpu) = true;
+    enable_interrupts();
+    for (int i = 0; i < SOFTIRQ_MAX_RESTARTS; i++)
+    {
+        struct softirq_work *list = __atomic_exchange_n(&per_cpu(softirq_queue, cpu), 0, __ATOMIC_ACQUIRE);
+        if (!list)
+        {
+            break;
+        }
+
+        softirq_run_list(list);
+    }
+
+    disable_interrupts();
+    per_cpu(softirq_running, cpu) = false;
+    cpu_irq_restore(flags);
+}
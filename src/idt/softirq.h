@@ -0,0 +1,35 @@
+#ifndef SOFTIRQ_H
+#define SOFTIRQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void (*SOFTIRQ_FUNCTION)(void *data);
+
+/**
+ * Deferred interrupt work. A top half raises it and the function runs later with interrupts
+ * enabled on the kernel page tables, either right after the EOI or from the kernel main loop.
+ * Work items must live in static memory so a top half can queue them from any address space.
+ */
+struct softirq_work
+{
+    SOFTIRQ_FUNCTION function;
+    void *data;
+
+    // Set while the item is queued, raising it again before it runs is a no-op
+    volatile uint32_t pending;
+    struct softirq_work *next;
+};
+
+void softirq_work_init(struct softirq_work *work, SOFTIRQ_FUNCTION function, void *data);
+
+// Queues the work on this CPU, lock free so it is safe from any top half. False if already queued
+bool softirq_raise(struct softirq_work *work);
+
+// True when this CPU has queued work
+bool softirq_pending();
+
+// Runs this CPU's queued work with interrupts enabled, nested calls return straight away
+void softirq_run();
+
+#endif
@@ -0,0 +1,389 @@
+#include "apic.h"
+#include "pic.h"
+#include "cpu/cpu.h"
+#include "io/io.h"
+#include "config.h"
+#include "status.h"
+#include "memory/memory.h"
+#include "debug/simple_serial.h"
+
+// Interrupt mode configuration register, routes the 8259 output away from LINT0 when present
+#define APIC_IMCR_SELECT 0x22
+#define APIC_IMCR_DATA 0x23
+
+#define ACPI_MADT_LOCAL_APIC 0
+#define ACPI_MADT_IO_APIC 1
+#define ACPI_MADT_SOURCE_OVERRIDE 2
+
+#define ACPI_MADT_POLARITY_LOW 0x03
+#define ACPI_MADT_TRIGGER_LEVEL 0x0C
+
+struct acpi_rsdp
+{
+    char signature[8];
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;
+    uint32_t rsdt_address;
+} __attribute__((packed));
+
+struct acpi_sdt_header
+{
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed));
+
+struct acpi_madt
+{
+    struct acpi_sdt_header header;
+    uint32_t lapic_address;
+    uint32_t flags;
+} __attribute__((packed));
+
+struct acpi_madt_entry
+{
+    uint8_t type;
+    uint8_t length;
+} __attribute__((packed));
+
+struct ioapic
+{
+    volatile uint32_t *base;
+    uint32_t gsi_base;
+    uint32_t gsi_count;
+};
+
+// Where each ISA IRQ really lands, identity unless the MADT overrides it
+struct apic_isa_route
+{
+    uint32_t gsi;
+    uint32_t flags;
+};
+
+static volatile uint32_t *lapic_base = 0;
+static struct ioapic ioapics[APIC_MAX_IOAPICS];
+static int ioapic_count = 0;
+static struct apic_isa_route isa_routes[APIC_ISA_IRQS];
+static int cpu_lapic_ids[VIOS_MAX_CPUS];
+static int cpu_lapic_count = 0;
+
+static uint32_t lapic_read(uint32_t reg)
+{
+    return lapic_base[reg / 4];
+}
+
+static void lapic_write(uint32_t reg, uint32_t value)
+{
+    lapic_base[reg / 4] = value;
+}
+
+static uint32_t ioapic_read(struct ioapic *ioapic, uint32_t reg)
+{
+    ioapic->base[IOAPIC_REG_SELECT / 4] = reg;
+    return ioapic->base[IOAPIC_REG_WINDOW / 4];
+}
+
+static void ioapic_write(struct ioapic *ioapic, uint32_t reg, uint32_t value)
+{
+    ioapic->base[IOAPIC_REG_SELECT / 4] = reg;
+    ioapic->base[IOAPIC_REG_WINDOW / 4] = value;
+}
+
+static bool acpi_checksum_ok(const void *table, uint32_t length)
+{
+    const uint8_t *bytes = table;
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        sum += bytes[i];
+    }
+
+    return sum == 0;
+}
+
+static struct acpi_rsdp *acpi_scan_rsdp(uint32_t start, uint32_t end)
+{
+    for (uint32_t address = start; address + sizeof(struct acpi_rsdp) <= end; address += 16)
+    {
+        struct acpi_rsdp *rsdp = (struct acpi_rsdp *)address;
+        if (memcmp(rsdp->signature, "RSD PTR ", 8) == 0 && acpi_checksum_ok(rsdp, sizeof(struct acpi_rsdp)))
+        {
+            return rsdp;
+        }
+    }
+
+    return 0;
+}
+
+static struct acpi_madt *acpi_find_madt()
+{
+    // The RSDP sits in the first KiB of the EBDA or in the BIOS area below 1MB
+    uint32_t ebda = (uint32_t)(*(volatile uint16_t *)0x40E) << 4;
+    struct acpi_rsdp *rsdp = 0;
+    if (ebda)
+    {
+        rsdp = acpi_scan_rsdp(ebda, ebda + 1024);
+    }
+    if (!rsdp)
+    {
+        rsdp = acpi_scan_rsdp(0xE0000, 0x100000);
+    }
+    if (!rsdp)
+    {
+        return 0;
+    }
+
+    struct acpi_sdt_header *rsdt = (struct acpi_sdt_header *)rsdp->rsdt_address;
+    if (!rsdt || memcmp(rsdt->signature, "RSDT", 4) != 0 || !acpi_checksum_ok(rsdt, rsdt->length))
+    {
+        return 0;
+    }
+
+    uint32_t *tables = (uint32_t *)((uint8_t *)rsdt + sizeof(struct acpi_sdt_header));
+    uint32_t total = (rsdt->length - sizeof(struct acpi_sdt_header)) / 4;
+    for (uint32_t i = 0; i < total; i++)
+    {
+        struct acpi_sdt_header *table = (struct acpi_sdt_header *)tables[i];
+        if (memcmp(table->signature, "APIC", 4) == 0 && acpi_checksum_ok(table, table->length))
+        {
+            return (struct acpi_madt *)table;
+        }
+    }
+
+    return 0;
+}
+
+static void apic_parse_madt(struct acpi_madt *madt)
+{
+    for (int i = 0; i < APIC_ISA_IRQS; i++)
+    {
+        isa_routes[i].gsi = i;
+        isa_routes[i].flags = 0;
+    }
+
+    uint8_t *entry = (uint8_t *)madt + sizeof(struct acpi_madt);
+    uint8_t *end = (uint8_t *)madt + madt->header.length;
+    while (entry + sizeof(struct acpi_madt_entry) <= end)
+    {
+        struct acpi_madt_entry *header = (struct acpi_madt_entry *)entry;
+        if (header->length < sizeof(struct acpi_madt_entry))
+        {
+            break;
+        }
+
+        switch (header->type)
+        {
+        case ACPI_MADT_LOCAL_APIC:
+            // acpi processor id, apic id, flags with bit 0 meaning enabled
+            if ((*(uint32_t *)(entry + 4) & 0x01) && cpu_lapic_count < VIOS_MAX_CPUS)
+            {
+                cpu_lapic_ids[cpu_lapic_count++] = entry[3];
+            }
+            break;
+
+        case ACPI_MADT_IO_APIC:
+            // id, reserved, address, gsi base
+            if (ioapic_count < APIC_MAX_IOAPICS)
+            {
+                struct ioapic *ioapic = &ioapics[ioapic_count++];
+                ioapic->base = (volatile uint32_t *)*(uint32_t *)(entry + 4);
+                ioapic->gsi_base = *(uint32_t *)(entry + 8);
+                ioapic->gsi_count = ((ioapic_read(ioapic, IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+            }
+            break;
+
+        case ACPI_MADT_SOURCE_OVERRIDE:
+        {
+            // bus, source irq, gsi, mps inti flags
+            uint8_t irq = entry[3];
+            if (irq < APIC_ISA_IRQS)
+            {
+                uint16_t flags = *(uint16_t *)(entry + 8);
+                isa_routes[irq].gsi = *(uint32_t *)(entry + 4);
+                isa_routes[irq].flags = 0;
+                if ((flags & 0x03) == ACPI_MADT_POLARITY_LOW)
+                {
+                    isa_routes[irq].flags |= IOAPIC_REDIRECT_ACTIVE_LOW;
+                }
+                if ((flags & 0x0C) == ACPI_MADT_TRIGGER_LEVEL)
+                {
+                    isa_routes[irq].flags |= IOAPIC_REDIRECT_LEVEL;
+                }
+            }
+            break;
+        }
+        }
+
+        entry += header->length;
+    }
+}
+
+static struct ioapic *apic_ioapic_for_gsi(uint32_t gsi)
+{
+    for (int i = 0; i < ioapic_count; i++)
+    {
+        if (gsi >= ioapics[i].gsi_base && gsi < ioapics[i].gsi_base + ioapics[i].gsi_count)
+        {
+            return &ioapics[i];
+        }
+    }
+
+    return 0;
+}
+
+bool apic_init()
+{
+    const struct cpu_features *features = cpu_get_features();
+    if (!features->apic || !features->msr)
+    {
+        return false;
+    }
+
+    struct acpi_madt *madt = acpi_find_madt();
+    if (!madt)
+    {
+        simple_serial_puts("  No ACPI MADT, staying on the 8259 PIC\n");
+        return false;
+    }
+
+    apic_parse_madt(madt);
+    if (ioapic_count == 0 || cpu_lapic_count == 0)
+    {
+        simple_serial_puts("  MADT lists no usable APICs, staying on the 8259 PIC\n");
+        return false;
+    }
+
+    uint64_t base = cpu_read_msr(APIC_BASE_MSR);
+    cpu_write_msr(APIC_BASE_MSR, base | APIC_BASE_MSR_ENABLE);
+    lapic_base = (volatile uint32_t *)(uint32_t)(base & 0xFFFFF000);
+
+    // Every ISA line starts masked, drivers open them through irq_unmask
+    pic_mask_all();
+    for (int i = 0; i < ioapic_count; i++)
+    {
+        for (uint32_t pin = 0; pin < ioapics[i].gsi_count; pin++)
+        {
+            ioapic_write(&ioapics[i], IOAPIC_REG_REDIRECTION + pin * 2, IOAPIC_REDIRECT_MASKED);
+            ioapic_write(&ioapics[i], IOAPIC_REG_REDIRECTION + pin * 2 + 1, 0);
+        }
+    }
+
+    outb(APIC_IMCR_SELECT, 0x70);
+    outb(APIC_IMCR_DATA, 0x01);
+
+    lapic_write(LAPIC_REG_TPR, 0);
+    lapic_write(LAPIC_REG_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+    lapic_write(LAPIC_REG_LVT_TIMER, LAPIC_LVT_MASKED);
+
+    simple_serial_puts("  Local APIC and I/O APIC enabled\n");
+    return true;
+}
+
+void apic_end_of_interrupt()
+{
+    lapic_write(LAPIC_REG_EOI, 0);
+}
+
+int apic_cpu_lapic_id(int cpu)
+{
+    if (cpu < 0 || cpu >= cpu_lapic_count)
+    {
+        return -EINVARG;
+    }
+
+    return cpu_lapic_ids[cpu];
+}
+
+int apic_route_irq(int irq, int vector, int cpu, bool masked)
+{
+    if (irq < 0 || irq >= APIC_ISA_IRQS)
+    {
+        return -EINVARG;
+    }
+
+    int lapic_id = apic_cpu_lapic_id(cpu);
+    struct ioapic *ioapic = apic_ioapic_for_gsi(isa_routes[irq].gsi);
+    if (lapic_id < 0 || !ioapic)
+    {
+        return -EINVARG;
+    }
+
+    uint32_t pin = isa_routes[irq].gsi - ioapic->gsi_base;
+    uint32_t low = (vector & 0xFF) | isa_routes[irq].flags;
+    if (masked)
+    {
+        low |= IOAPIC_REDIRECT_MASKED;
+    }
+
+    // Mask while the destination changes so the entry is never half written
+    ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + pin * 2, IOAPIC_REDIRECT_MASKED);
+    ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + pin * 2 + 1, (uint32_t)lapic_id << 24);
+    ioapic_write(ioapic, IOAPIC_REG_REDIRECTION + pin * 2, low);
+    return 0;
+}
+
+void apic_set_irq_masked(int irq, bool masked)
+{
+    if (irq < 0 || irq >= APIC_ISA_IRQS)
+    {
+        return;
+    }
+
+    struct ioapic *ioapic = apic_ioapic_for_gsi(isa_routes[irq].gsi);
+    if (!ioapic)
+    {
+        return;
+    }
+
+    uint32_t reg = IOAPIC_REG_REDIRECTION + (isa_routes[irq].gsi - ioapic->gsi_base) * 2;
+    uint32_t low = ioapic_read(ioapic, reg);
+    if (masked)
+    {
+        low |= IOAPIC_REDIRECT_MASKED;
+    }
+    else
+    {
+        low &= ~IOAPIC_REDIRECT_MASKED;
+    }
+    ioapic_write(ioapic, reg, low);
+}
+
+void apic_timer_oneshot(uint32_t initial_count)
+{
+    lapic_write(LAPIC_REG_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_16);
+    lapic_write(LAPIC_REG_LVT_TIMER, LAPIC_LVT_MASKED | APIC_TIMER_VECTOR);
+    lapic_write(LAPIC_REG_TIMER_INITIAL, initial_count);
+}
+
+void apic_timer_periodic(uint32_t initial_count, int vector)
+{
+    lapic_write(LAPIC_REG_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_16);
+    lapic_write(LAPIC_REG_LVT_TIMER, LAPIC_LVT_MASKED | LAPIC_TIMER_PERIODIC | (vector & 0xFF));
+    lapic_write(LAPIC_REG_TIMER_INITIAL, initial_count);
+}
+
+uint32_t apic_timer_current()
+{
+    return lapic_read(LAPIC_REG_TIMER_CURRENT);
+}
+
+void apic_timer_set_masked(bool masked)
+{
+    uint32_t lvt = lapic_read(LAPIC_REG_LVT_TIMER);
+    if (masked)
+    {
+        lvt |= LAPIC_LVT_MASKED;
+    }
+    else
+    {
+        lvt &= ~LAPIC_LVT_MASKED;
+    }
+    lapic_write(LAPIC_REG_LVT_TIMER, lvt);
+}
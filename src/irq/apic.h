@@ -0,0 +1,63 @@
+#ifndef APIC_H
+#define APIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define APIC_BASE_MSR 0x1B
+#define APIC_BASE_MSR_ENABLE 0x800
+
+// Local APIC registers, offsets from the MMIO base
+#define LAPIC_REG_ID 0x20
+#define LAPIC_REG_TPR 0x80
+#define LAPIC_REG_EOI 0xB0
+#define LAPIC_REG_SVR 0xF0
+#define LAPIC_REG_LVT_TIMER 0x320
+#define LAPIC_REG_TIMER_INITIAL 0x380
+#define LAPIC_REG_TIMER_CURRENT 0x390
+#define LAPIC_REG_TIMER_DIVIDE 0x3E0
+
+#define LAPIC_SVR_ENABLE 0x100
+#define LAPIC_LVT_MASKED 0x10000
+#define LAPIC_TIMER_PERIODIC 0x20000
+#define LAPIC_TIMER_DIVIDE_16 0x03
+
+// I/O APIC registers, reached through the select/window pair
+#define IOAPIC_REG_SELECT 0x00
+#define IOAPIC_REG_WINDOW 0x10
+#define IOAPIC_REG_VERSION 0x01
+#define IOAPIC_REG_REDIRECTION 0x10
+
+#define IOAPIC_REDIRECT_ACTIVE_LOW 0x2000
+#define IOAPIC_REDIRECT_LEVEL 0x8000
+#define IOAPIC_REDIRECT_MASKED 0x10000
+
+#define APIC_MAX_IOAPICS 4
+#define APIC_ISA_IRQS 16
+
+// Vectors above the remapped PIC range
+#define APIC_TIMER_VECTOR 0x30
+#define APIC_SPURIOUS_VECTOR 0xFF
+
+/**
+ * Finds the local and I/O APICs through the ACPI MADT and takes over from the 8259s.
+ * Returns false, leaving the PIC in charge, when either is missing.
+ */
+bool apic_init();
+
+void apic_end_of_interrupt();
+
+// Local APIC id of a logical CPU, as listed in the MADT
+int apic_cpu_lapic_id(int cpu);
+
+// Points an ISA IRQ at a vector and CPU, honouring the MADT source overrides
+int apic_route_irq(int irq, int vector, int cpu, bool masked);
+void apic_set_irq_masked(int irq, bool masked);
+
+// LAPIC timer on this CPU, counts down from initial_count at bus clock / 16
+void apic_timer_oneshot(uint32_t initial_count);
+void apic_timer_periodic(uint32_t initial_count, int vector);
+uint32_t apic_timer_current();
+void apic_timer_set_masked(bool masked);
+
+#endif
@@ -0,0 +1,123 @@
+#include "irq.h"
+#include "pic.h"
+#include "apic.h"
+#include "cpu/cpu.h"
+#include "status.h"
+
+static bool irq_apic = false;
+
+// Masked state and target CPU per line, reapplied when the affinity changes
+static bool irq_masked[IRQ_LINES];
+static int irq_affinity[IRQ_LINES];
+
+void irq_init()
+{
+    for (int i = 0; i < IRQ_LINES; i++)
+    {
+        irq_masked[i] = true;
+        irq_affinity[i] = 0;
+    }
+
+    irq_apic = apic_init();
+    if (!irq_apic)
+    {
+        return;
+    }
+
+    for (int i = 0; i < IRQ_LINES; i++)
+    {
+        apic_route_irq(i, IRQ_VECTOR(i), irq_affinity[i], true);
+    }
+}
+
+bool irq_using_apic()
+{
+    return irq_apic;
+}
+
+void irq_mask(int irq)
+{
+    if (irq < 0 || irq >= IRQ_LINES)
+    {
+        return;
+    }
+
+    irq_masked[irq] = true;
+    if (irq_apic)
+    {
+        apic_set_irq_masked(irq, true);
+        return;
+    }
+
+    pic_mask(irq);
+}
+
+void irq_unmask(int irq)
+{
+    if (irq < 0 || irq >= IRQ_LINES)
+    {
+        return;
+    }
+
+    irq_masked[irq] = false;
+    if (irq_apic)
+    {
+        apic_set_irq_masked(irq, false);
+        return;
+    }
+
+    pic_unmask(irq);
+}
+
+int irq_set_affinity(int irq, int cpu)
+{
+    if (irq < 0 || irq >= IRQ_LINES || !cpu_is_online(cpu))
+    {
+        return -EINVARG;
+    }
+
+    if (!irq_apic)
+    {
+        // The 8259s are wired to the bootstrap processor only
+        return cpu == 0 ? 0 : -EUNIMP;
+    }
+
+    int res = apic_route_irq(irq, IRQ_VECTOR(irq), cpu, irq_masked[irq]);
+    if (res < 0)
+    {
+        return res;
+    }
+
+    irq_affinity[irq] = cpu;
+    return 0;
+}
+
+int irq_get_affinity(int irq)
+{
+    if (irq < 0 || irq >= IRQ_LINES)
+    {
+        return -EINVARG;
+    }
+
+    return irq_affinity[irq];
+}
+
+void irq_end_of_interrupt(int vector)
+{
+    if (irq_apic)
+    {
+        // A spurious interrupt never sets an in-service bit, acknowledging it would drop a real one
+        if (vector == APIC_SPURIOUS_VECTOR || vector < IRQ_VECTOR_BASE)
+        {
+            return;
+        }
+
+        apic_end_of_interrupt();
+        return;
+    }
+
+    if (vector >= IRQ_VECTOR_BASE && vector < IRQ_VECTOR(IRQ_LINES))
+    {
+        pic_end_of_interrupt(vector - IRQ_VECTOR_BASE);
+    }
+}
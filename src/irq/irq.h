@@ -0,0 +1,32 @@
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <stdbool.h>
+
+// ISA IRQ lines keep their remapped PIC vectors under the I/O APIC as well
+#define IRQ_VECTOR_BASE 0x20
+#define IRQ_VECTOR(irq) (IRQ_VECTOR_BASE + (irq))
+#define IRQ_LINES 16
+
+#define IRQ_TIMER 0
+#define IRQ_KEYBOARD 1
+#define IRQ_MOUSE 12
+
+/**
+ * Picks the interrupt controller. The local and I/O APICs are used when the MADT describes
+ * them, otherwise the legacy 8259 pair stays in charge. Call after idt_init and before drivers.
+ */
+void irq_init();
+bool irq_using_apic();
+
+void irq_mask(int irq);
+void irq_unmask(int irq);
+
+// Delivers an IRQ to another CPU, only the bootstrap CPU is accepted on the PIC
+int irq_set_affinity(int irq, int cpu);
+int irq_get_affinity(int irq);
+
+// Acknowledges the interrupt behind a vector, exceptions and the APIC spurious vector need none
+void irq_end_of_interrupt(int vector);
+
+#endif
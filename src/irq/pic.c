@@ -0,0 +1,38 @@
+#include "pic.h"
+#include "io/io.h"
+
+void pic_mask(int irq)
+{
+    uint16_t port = irq < 8 ? PIC_MASTER_DATA : PIC_SLAVE_DATA;
+    uint8_t mask = insb(port);
+    mask |= (1 << (irq % 8));
+    outb(port, mask);
+}
+
+void pic_unmask(int irq)
+{
+    if (irq >= 8)
+    {
+        pic_unmask(PIC_CASCADE_IRQ);
+    }
+
+    uint16_t port = irq < 8 ? PIC_MASTER_DATA : PIC_SLAVE_DATA;
+    uint8_t mask = insb(port);
+    mask &= ~(1 << (irq % 8));
+    outb(port, mask);
+}
+
+void pic_mask_all()
+{
+    outb(PIC_MASTER_DATA, 0xFF);
+    outb(PIC_SLAVE_DATA, 0xFF);
+}
+
+void pic_end_of_interrupt(int irq)
+{
+    if (irq >= 8)
+    {
+        outb(PIC_SLAVE_COMMAND, PIC_EOI);
+    }
+    outb(PIC_MASTER_COMMAND, PIC_EOI);
+}
@@ -0,0 +1,21 @@
+#ifndef PIC_H
+#define PIC_H
+
+#include <stdint.h>
+
+// Legacy 8259 pair, remapped to vectors 0x20 - 0x2F by kernel.asm with every line masked
+#define PIC_MASTER_COMMAND 0x20
+#define PIC_MASTER_DATA 0x21
+#define PIC_SLAVE_COMMAND 0xA0
+#define PIC_SLAVE_DATA 0xA1
+#define PIC_EOI 0x20
+#define PIC_CASCADE_IRQ 2
+
+void pic_mask(int irq);
+
+// Unmasking a slave line also opens the cascade on the master
+void pic_unmask(int irq);
+void pic_mask_all();
+void pic_end_of_interrupt(int irq);
+
+#endif
@@ -0,0 +1,61 @@
+#include "batch.h"
+#include "isr80h.h"
+#include "task/task.h"
+#include "memory/heap/kheap.h"
+#include "idt/idt.h"
+#include "config.h"
+#include "status.h"
+#include "kernel.h"
+
+void *isr80h_command47_batch(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = struct isr80h_batch_entry array, ECX = number of entries
+    // Returns the number of entries run, each entry's result field holds its EAX
+    struct task *task = task_current();
+    int count = (int)frame->ecx;
+    if (count <= 0 || count > VIOS_MAX_BATCH_ENTRIES)
+    {
+        return ERROR(-EINVARG);
+    }
+
+    // One copy validates the whole array, the handlers then run on the kernel's copy
+    int size = count * sizeof(struct isr80h_batch_entry);
+    struct isr80h_batch_entry *entries = kmalloc(size);
+    if (!entries)
+    {
+        return ERROR(-ENOMEM);
+    }
+
+    int res = copy_from_task(task, entries, (void *)frame->ebx, size);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        struct isr80h_batch_entry *entry = &entries[i];
+        if (!isr80h_command_queueable(entry->command))
+        {
+            entry->result = -EINVARG;
+            continue;
+        }
+
+        entry->result = (int32_t)isr80h_dispatch_queued(task, entry->command, entry->args, ISR80H_BATCH_ARGS);
+    }
+
+    res = copy_to_task(task, (void *)frame->ebx, entries, size);
+    if (res == 0)
+    {
+        res = count;
+    }
+
+out:
+    kfree(entries);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
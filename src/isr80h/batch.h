@@ -0,0 +1,19 @@
+#ifndef ISR80H_BATCH_H
+#define ISR80H_BATCH_H
+
+#include <stdint.h>
+
+#define ISR80H_BATCH_ARGS 5
+
+// One record of a batch, result is written back once the command has run
+struct isr80h_batch_entry
+{
+    uint32_t command;
+    uint32_t args[ISR80H_BATCH_ARGS];
+    int32_t result;
+};
+
+struct interrupt_frame;
+void *isr80h_command47_batch(struct interrupt_frame *frame);
+
+#endif
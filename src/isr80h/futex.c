@@ -0,0 +1,39 @@
+#include "futex.h"
+#include "sync/futex.h"
+#include "task/task.h"
+#include "idt/idt.h"
+#include "kernel.h"
+#include <stdint.h>
+
+void *isr80h_command28_futex_wait(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = user address, ECX = expected value
+    struct task *task = task_current();
+    int res = futex_wait(task, (void *)frame->ebx, (uint32_t)frame->ecx);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    // Blocked, futex_wake sets our return value and puts us back on a run queue
+    task_next();
+    return 0;
+}
+
+void *isr80h_command29_futex_wake(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = user address, ECX = maximum number of tasks to wake
+    int count = (int)frame->ecx;
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    int res = futex_wake(task_current(), (void *)frame->ebx, count);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
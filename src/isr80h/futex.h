@@ -0,0 +1,8 @@
+#ifndef ISR80H_FUTEX_H
+#define ISR80H_FUTEX_H
+
+struct interrupt_frame;
+void *isr80h_command28_futex_wait(struct interrupt_frame *frame);
+void *isr80h_command29_futex_wake(struct interrupt_frame *frame);
+
+#endif
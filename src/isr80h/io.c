@@ -3,6 +3,33 @@
 #include "graphics/graphics.h"
 #include "keyboard/keyboard.h"
 #include "rtc/rtc.h"
+#include "time/ktime.h"
+#include "idt/idt.h"
+#include "task/process.h"
+#include "fs/pipe.h"
+#include "string/string.h"
+#include "status.h"
+
+// Sends console output to stdout's pipe when the process is part of a pipeline.
+// Returns false when stdout is still the console and the caller should draw instead.
+static bool isr80h_stdout_redirect(const char *buf, int size)
+{
+    struct task *task = task_current();
+    struct process_fd *out = process_fd_get(task->process, PROCESS_FD_STDOUT);
+    if (!out || out->type != PROCESS_FD_PIPE_WRITE)
+    {
+        return false;
+    }
+
+    if (pipe_write(out->pipe, task, buf, size) == -EAGAIN)
+    {
+        // Pipe full, print again once the reader has drained it
+        task_restart_syscall(task);
+        task_next();
+    }
+
+    return true;
+}
 
 void *isr80h_command1_print(struct interrupt_frame *frame)
 {
@@ -15,6 +42,10 @@ void *isr80h_command1_print(struct interrupt_frame *frame)
     int s = (int)task_get_stack_item(task_current(), 6);
     char buf[1024];
     copy_string_from_task(task_current(), user_space_msg_buffer, buf, sizeof(buf));
+    if (isr80h_stdout_redirect(buf, strnlen(buf, sizeof(buf))))
+    {
+        return 0;
+    }
 
     DrawAtariString(buf, x, y, r, g, b, s);
     return 0;
@@ -22,6 +53,22 @@ void *isr80h_command1_print(struct interrupt_frame *frame)
 
 void *isr80h_command2_getkey(struct interrupt_frame *frame)
 {
+    struct task *task = task_current();
+    struct process_fd *in = process_fd_get(task->process, PROCESS_FD_STDIN);
+    if (in && in->type == PROCESS_FD_PIPE_READ)
+    {
+        char c = 0;
+        int res = pipe_read(in->pipe, task, &c, 1);
+        if (res == -EAGAIN)
+        {
+            task_restart_syscall(task);
+            task_next();
+        }
+
+        // -1 once the writing end has closed and everything was read
+        return (void *)(res == 1 ? (int)c : -1);
+    }
+
     char c = keyboard_pop();
     return (void *)((int)c);
 }
@@ -35,6 +82,10 @@ void *isr80h_command3_putchar(struct interrupt_frame *frame)
     int g = (int)(task_current(), 4);
     int b = (int)(task_current(), 5);
     int s = (int)(task_current(), 6);
+    if (isr80h_stdout_redirect(&c, 1))
+    {
+        return 0;
+    }
 
     DrawAtariChar(c, x, y, r, g, b, s);
     return 0;
@@ -49,4 +100,12 @@ void *isr80h_command9_sleep(struct interrupt_frame *frame)
     }
     sleep_seconds(seconds);
     return 0;
-}
\ No newline at end of file
+}
+
+void *isr80h_command30_ktime_ns(struct interrupt_frame *frame)
+{
+    // Returns the 64-bit monotonic time in EDX:EAX
+    uint64_t now = ktime_ns();
+    frame->edx = (uint32_t)(now >> 32);
+    return (void *)(uint32_t)now;
+}
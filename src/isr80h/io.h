@@ -6,5 +6,6 @@ void *isr80h_command1_print(struct interrupt_frame *frame);
 void *isr80h_command2_getkey(struct interrupt_frame *frame);
 void *isr80h_command3_putchar(struct interrupt_frame *frame);
 void *isr80h_command9_sleep(struct interrupt_frame *frame);
+void *isr80h_command30_ktime_ns(struct interrupt_frame *frame);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "ipc.h"
+#include "task/ipc.h"
+#include "task/task.h"
+#include "task/process.h"
+#include "idt/idt.h"
+#include "kernel.h"
+
+// Message registers: ECX, EDX, EDI = words, ESI = payload allocation (or 0)
+static void isr80h_ipc_message_from_frame(struct interrupt_frame *frame, struct ipc_message *message)
+{
+    message->words[0] = frame->ecx;
+    message->words[1] = frame->edx;
+    message->words[2] = frame->edi;
+    message->payload = (void *)frame->esi;
+}
+
+void *isr80h_command31_ipc_port_create(struct interrupt_frame *frame)
+{
+    int res = ipc_port_create(task_current()->process);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
+
+void *isr80h_command32_ipc_port_destroy(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = port
+    return ERROR(ipc_port_destroy(task_current()->process, (int)frame->ebx));
+}
+
+void *isr80h_command33_ipc_send(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = port, message registers. The reply comes back in the same registers
+    struct ipc_message message;
+    isr80h_ipc_message_from_frame(frame, &message);
+
+    int res = ipc_send(task_current()->process, (int)frame->ebx, &message);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    // Blocked until the receiver replies, ipc_reply fills in our registers
+    task_next();
+    return 0;
+}
+
+void *isr80h_command34_ipc_receive(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = port. Returns the sender id to pass to reply, message in registers
+    struct ipc_message message;
+    int sender_id = 0;
+    int res = ipc_receive(task_current()->process, (int)frame->ebx, &message, &sender_id);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    if (res > 0)
+    {
+        // Nothing queued, ipc_send fills in our registers once a sender arrives
+        task_next();
+        return 0;
+    }
+
+    frame->ecx = message.words[0];
+    frame->edx = message.words[1];
+    frame->edi = message.words[2];
+    frame->esi = (uint32_t)message.payload;
+    return (void *)sender_id;
+}
+
+void *isr80h_command35_ipc_reply(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = sender id from receive, message registers
+    struct ipc_message message;
+    isr80h_ipc_message_from_frame(frame, &message);
+    return ERROR(ipc_reply(task_current()->process, (int)frame->ebx, &message));
+}
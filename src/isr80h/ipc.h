@@ -0,0 +1,11 @@
+#ifndef ISR80H_IPC_H
+#define ISR80H_IPC_H
+
+struct interrupt_frame;
+void *isr80h_command31_ipc_port_create(struct interrupt_frame *frame);
+void *isr80h_command32_ipc_port_destroy(struct interrupt_frame *frame);
+void *isr80h_command33_ipc_send(struct interrupt_frame *frame);
+void *isr80h_command34_ipc_receive(struct interrupt_frame *frame);
+void *isr80h_command35_ipc_reply(struct interrupt_frame *frame);
+
+#endif
@@ -7,7 +7,17 @@
 #include "file.h"
 #include "vix_graphics.h"
 #include "sound.h"
+#include "futex.h"
+#include "ipc.h"
+#include "pipe.h"
+#include "shm.h"
+#include "ring.h"
+#include "batch.h"
+#include "trace.h"
+#include "window.h"
 #include "../debug/simple_serial.h"
+#include "task/task.h"
+#include "memory/memory.h"
 
 // Include keyboard system call handlers
 void *isr80h_command24_keyboard_read(struct interrupt_frame *frame);
@@ -21,6 +31,8 @@ void *isr80h_command25_keyboard_state(struct interrupt_frame *frame);
  */
 void isr80h_register_commands()
 {
+    isr80h_trace_init();
+
     simple_serial_puts("Registering command 0\n");
     isr80h_register_command(SYSTEM_COMMAND0_EXIT, isr80h_command0_exit);
     simple_serial_puts("Command 0 registered\n");
@@ -80,6 +92,11 @@ void isr80h_register_commands()
     isr80h_register_command(SYSTEM_COMMAND21_VIX_DRAW_TEXT_SCALED, isr80h_command21_vix_draw_text_scaled);
     isr80h_register_command(SYSTEM_COMMAND22_VIX_TEXT_WIDTH, isr80h_command22_vix_text_width);
     isr80h_register_command(SYSTEM_COMMAND23_VIX_TEXT_HEIGHT, isr80h_command23_vix_text_height);
+    isr80h_register_command(SYSTEM_COMMAND49_VIX_SURFACE_CREATE, isr80h_command49_vix_surface_create);
+    isr80h_register_command(SYSTEM_COMMAND50_VIX_SURFACE_PRESENT, isr80h_command50_vix_surface_present);
+    isr80h_register_command(SYSTEM_COMMAND51_VIX_SUBMIT, isr80h_command51_vix_submit);
+    isr80h_register_command(SYSTEM_COMMAND52_WINDOW_CREATE, isr80h_command52_window_create);
+    isr80h_register_command(SYSTEM_COMMAND53_WINDOW_CONTROL, isr80h_command53_window_control);
     
     simple_serial_puts("All VIX commands registered\n");
     
@@ -88,4 +105,84 @@ void isr80h_register_commands()
     // isr80h_register_command(SYSTEM_COMMAND25_KEYBOARD_STATE, isr80h_command25_keyboard_state);
     // isr80h_register_command(SYSTEM_COMMAND26_SOUND_PLAY, isr80h_command26_sound_play);
     // isr80h_register_command(SYSTEM_COMMAND27_SOUND_STOP, isr80h_command27_sound_stop);
+
+    isr80h_register_command(SYSTEM_COMMAND28_FUTEX_WAIT, isr80h_command28_futex_wait);
+    isr80h_register_command(SYSTEM_COMMAND29_FUTEX_WAKE, isr80h_command29_futex_wake);
+    isr80h_register_command(SYSTEM_COMMAND30_KTIME_NS, isr80h_command30_ktime_ns);
+
+    isr80h_register_command(SYSTEM_COMMAND31_IPC_PORT_CREATE, isr80h_command31_ipc_port_create);
+    isr80h_register_command(SYSTEM_COMMAND32_IPC_PORT_DESTROY, isr80h_command32_ipc_port_destroy);
+    isr80h_register_command(SYSTEM_COMMAND33_IPC_SEND, isr80h_command33_ipc_send);
+    isr80h_register_command(SYSTEM_COMMAND34_IPC_RECEIVE, isr80h_command34_ipc_receive);
+    isr80h_register_command(SYSTEM_COMMAND35_IPC_REPLY, isr80h_command35_ipc_reply);
+
+    isr80h_register_command(SYSTEM_COMMAND36_PIPE, isr80h_command36_pipe);
+    isr80h_register_command(SYSTEM_COMMAND37_FD_READ, isr80h_command37_fd_read);
+    isr80h_register_command(SYSTEM_COMMAND38_FD_WRITE, isr80h_command38_fd_write);
+    isr80h_register_command(SYSTEM_COMMAND39_FD_CLOSE, isr80h_command39_fd_close);
+    isr80h_register_command(SYSTEM_COMMAND40_PROCESS_SPAWN, isr80h_command40_process_spawn);
+    isr80h_register_command(SYSTEM_COMMAND41_PROCESS_WAIT, isr80h_command41_process_wait);
+
+    isr80h_register_command(SYSTEM_COMMAND42_SHM_CREATE, isr80h_command42_shm_create);
+    isr80h_register_command(SYSTEM_COMMAND43_SHM_MAP, isr80h_command43_shm_map);
+    isr80h_register_command(SYSTEM_COMMAND44_SHM_UNMAP, isr80h_command44_shm_unmap);
+
+    isr80h_register_command(SYSTEM_COMMAND45_RING_SETUP, isr80h_command45_ring_setup);
+    isr80h_register_command(SYSTEM_COMMAND46_RING_ENTER, isr80h_command46_ring_enter);
+    isr80h_register_command(SYSTEM_COMMAND47_BATCH, isr80h_command47_batch);
+    isr80h_register_command(SYSTEM_COMMAND48_SYSCALL_TRACE, isr80h_command48_syscall_trace);
+}
+
+/**
+ * Commands that can run from a batch or the syscall ring: the ones that return
+ * without blocking or switching tasks. Print and putchar stay out, they block on a
+ * full stdout pipe and would switch away with the queued stack still in place.
+ */
+bool isr80h_command_queueable(int command)
+{
+    switch (command)
+    {
+    case SYSTEM_COMMAND4_MALLOC:
+    case SYSTEM_COMMAND5_FREE:
+    case SYSTEM_COMMAND10_READ:
+    case SYSTEM_COMMAND29_FUTEX_WAKE:
+    case SYSTEM_COMMAND30_KTIME_NS:
+    case SYSTEM_COMMAND42_SHM_CREATE:
+    case SYSTEM_COMMAND43_SHM_MAP:
+    case SYSTEM_COMMAND44_SHM_UNMAP:
+    case SYSTEM_COMMAND49_VIX_SURFACE_CREATE:
+    case SYSTEM_COMMAND50_VIX_SURFACE_PRESENT:
+        return true;
+    }
+
+    return command >= SYSTEM_COMMAND11_VIX_DRAW_PIXEL && command <= SYSTEM_COMMAND23_VIX_TEXT_HEIGHT;
+}
+
+/**
+ * Runs a command from a queued record rather than a trap. args fill EBX, ECX, EDX, ESI and EDI
+ * of a synthesized frame, and double as the user stack for handlers that use task_get_stack_item.
+ * Only the EAX result is returned.
+ */
+void *isr80h_dispatch_queued(struct task *task, int command, const uint32_t *args, int argc)
+{
+    uint32_t stack[ISR80H_MAX_QUEUED_ARGS];
+    memset(stack, 0, sizeof(stack));
+    memcpy(stack, (void *)args, (argc < ISR80H_MAX_QUEUED_ARGS ? argc : ISR80H_MAX_QUEUED_ARGS) * sizeof(uint32_t));
+
+    struct interrupt_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.eax = command;
+    frame.ebx = stack[0];
+    frame.ecx = stack[1];
+    frame.edx = stack[2];
+    frame.esi = stack[3];
+    frame.edi = stack[4];
+    frame.esp = (uint32_t)stack;
+
+    // Point the saved user stack at our copy, kernel memory is identity mapped readable in every directory
+    uint32_t old_esp = task->registers.esp;
+    task->registers.esp = (uint32_t)stack;
+    void *result = isr80h_handle_command(command, &frame);
+    task->registers.esp = old_esp;
+    return result;
 }
@@ -1,7 +1,14 @@
 #ifndef ISR80H_H
 #define ISR80H_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
+// Most arguments a queued call can carry, print takes seven on its stack
+#define ISR80H_MAX_QUEUED_ARGS 7
+
 struct interrupt_frame;
+struct task;
 
 enum SystemCommands
 {
@@ -33,9 +40,38 @@ enum SystemCommands
     SYSTEM_COMMAND25_KEYBOARD_STATE,
     SYSTEM_COMMAND26_SOUND_PLAY,
     SYSTEM_COMMAND27_SOUND_STOP,
+    SYSTEM_COMMAND28_FUTEX_WAIT,
+    SYSTEM_COMMAND29_FUTEX_WAKE,
+    SYSTEM_COMMAND30_KTIME_NS,
+    SYSTEM_COMMAND31_IPC_PORT_CREATE,
+    SYSTEM_COMMAND32_IPC_PORT_DESTROY,
+    SYSTEM_COMMAND33_IPC_SEND,
+    SYSTEM_COMMAND34_IPC_RECEIVE,
+    SYSTEM_COMMAND35_IPC_REPLY,
+    SYSTEM_COMMAND36_PIPE,
+    SYSTEM_COMMAND37_FD_READ,
+    SYSTEM_COMMAND38_FD_WRITE,
+    SYSTEM_COMMAND39_FD_CLOSE,
+    SYSTEM_COMMAND40_PROCESS_SPAWN,
+    SYSTEM_COMMAND41_PROCESS_WAIT,
+    SYSTEM_COMMAND42_SHM_CREATE,
+    SYSTEM_COMMAND43_SHM_MAP,
+    SYSTEM_COMMAND44_SHM_UNMAP,
+    SYSTEM_COMMAND45_RING_SETUP,
+    SYSTEM_COMMAND46_RING_ENTER,
+    SYSTEM_COMMAND47_BATCH,
+    SYSTEM_COMMAND48_SYSCALL_TRACE,
+    SYSTEM_COMMAND49_VIX_SURFACE_CREATE,
+    SYSTEM_COMMAND50_VIX_SURFACE_PRESENT,
+    SYSTEM_COMMAND51_VIX_SUBMIT,
+    SYSTEM_COMMAND52_WINDOW_CREATE,
+    SYSTEM_COMMAND53_WINDOW_CONTROL,
 };
 
 void isr80h_register_commands();
+
+bool isr80h_command_queueable(int command);
+void *isr80h_dispatch_queued(struct task *task, int command, const uint32_t *args, int argc);
 void *isr80h_command6_process_load_start(struct interrupt_frame *frame);
 
 #endif
\ No newline at end of file
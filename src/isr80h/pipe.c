@@ -0,0 +1,170 @@
+#include "pipe.h"
+#include "fs/pipe.h"
+#include "task/task.h"
+#include "task/process.h"
+#include "keyboard/keyboard.h"
+#include "kernel/mainloop.h"
+#include "idt/idt.h"
+#include "status.h"
+#include "kernel.h"
+
+// Largest transfer handled by a single read or write call, callers loop for more
+#define ISR80H_PIPE_IO_CHUNK 512
+
+void *isr80h_command36_pipe(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = int[2] receiving the read and write descriptors
+    struct process *process = task_current()->process;
+    int fds[2] = {-1, -1};
+
+    struct pipe *pipe = pipe_new();
+    if (!pipe)
+    {
+        return ERROR(-ENOMEM);
+    }
+
+    int res = process_fd_install(process, -1, PROCESS_FD_PIPE_READ, pipe);
+    if (res < 0)
+    {
+        pipe_free(pipe);
+        return ERROR(res);
+    }
+    fds[0] = res;
+
+    // From here on the pipe frees itself once both of its ends have been closed
+    res = process_fd_install(process, -1, PROCESS_FD_PIPE_WRITE, pipe);
+    if (res < 0)
+    {
+        goto out;
+    }
+    fds[1] = res;
+
+    res = copy_to_task(task_current(), (void *)frame->ebx, fds, sizeof(fds));
+
+out:
+    if (res < 0)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            if (fds[i] >= 0)
+            {
+                process_fd_close(process, fds[i]);
+            }
+        }
+        return ERROR(res);
+    }
+
+    return 0;
+}
+
+void *isr80h_command37_fd_read(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = fd, ECX = user buffer, EDX = length
+    struct task *task = task_current();
+    struct process_fd *entry = process_fd_get(task->process, (int)frame->ebx);
+    if (!entry)
+    {
+        return ERROR(-EINVARG);
+    }
+
+    int size = (int)frame->edx;
+    if (size > ISR80H_PIPE_IO_CHUNK)
+    {
+        size = ISR80H_PIPE_IO_CHUNK;
+    }
+
+    char buf[ISR80H_PIPE_IO_CHUNK];
+    int res = 0;
+    switch (entry->type)
+    {
+    case PROCESS_FD_CONSOLE:
+        res = keyboard_read(task, buf, size);
+        break;
+
+    case PROCESS_FD_PIPE_READ:
+        res = pipe_read(entry->pipe, task, buf, size);
+        break;
+
+    default:
+        res = -EINVARG;
+    }
+
+    if (res == -EAGAIN)
+    {
+        // Queued on the keyboard or the pipe, the read runs again once there is input
+        task_restart_syscall(task);
+        task_next();
+    }
+
+    if (res > 0 && copy_to_task(task, (void *)frame->ecx, buf, res) < 0)
+    {
+        res = -EINVARG;
+    }
+
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
+
+void *isr80h_command38_fd_write(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = fd, ECX = user buffer, EDX = length
+    struct task *task = task_current();
+    struct process_fd *entry = process_fd_get(task->process, (int)frame->ebx);
+    if (!entry)
+    {
+        return ERROR(-EINVARG);
+    }
+
+    int size = (int)frame->edx;
+    if (size > ISR80H_PIPE_IO_CHUNK)
+    {
+        size = ISR80H_PIPE_IO_CHUNK;
+    }
+
+    char buf[ISR80H_PIPE_IO_CHUNK];
+    int res = copy_from_task(task, buf, (void *)frame->ecx, size);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    switch (entry->type)
+    {
+    case PROCESS_FD_CONSOLE:
+        for (int i = 0; i < size; i++)
+        {
+            kernel_terminal_putchar(buf[i]);
+        }
+        res = size;
+        break;
+
+    case PROCESS_FD_PIPE_WRITE:
+        res = pipe_write(entry->pipe, task, buf, size);
+        if (res == -EAGAIN)
+        {
+            task_restart_syscall(task);
+            task_next();
+        }
+        break;
+
+    default:
+        res = -EINVARG;
+    }
+
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
+
+void *isr80h_command39_fd_close(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = fd
+    return ERROR(process_fd_close(task_current()->process, (int)frame->ebx));
+}
@@ -0,0 +1,10 @@
+#ifndef ISR80H_PIPE_H
+#define ISR80H_PIPE_H
+
+struct interrupt_frame;
+void *isr80h_command36_pipe(struct interrupt_frame *frame);
+void *isr80h_command37_fd_read(struct interrupt_frame *frame);
+void *isr80h_command38_fd_write(struct interrupt_frame *frame);
+void *isr80h_command39_fd_close(struct interrupt_frame *frame);
+
+#endif
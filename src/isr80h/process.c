@@ -6,6 +6,7 @@
 #include "config.h"
 #include "kernel.h"
 #include "string/string.h"
+#include "idt/idt.h"
 
 void *isr80h_command6_process_load_start(struct interrupt_frame *frame)
 {
@@ -88,4 +89,99 @@ void *isr80h_command0_exit(struct interrupt_frame *frame)
     task_next();
 
     return 0;
-}
\ No newline at end of file
+}
+// Gives the child its own reference to one of the parent's descriptors
+static int isr80h_spawn_inherit(struct process *parent, int parent_fd, struct process *child, int child_fd)
+{
+    if (parent_fd < 0)
+    {
+        return 0;
+    }
+
+    struct process_fd *entry = process_fd_get(parent, parent_fd);
+    if (!entry)
+    {
+        return -EINVARG;
+    }
+
+    int res = process_fd_install(child, child_fd, entry->type, entry->pipe);
+    return res < 0 ? res : 0;
+}
+
+void *isr80h_command40_process_spawn(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = command arguments, ECX = fd for the child's stdin, EDX = fd for its stdout (-1 keeps the console)
+    // Unlike command 7 the caller keeps running, the child is only placed on a run queue.
+    struct task *task = task_current();
+    struct command_argument *arguments = task_virtual_address_to_physical(task, (void *)frame->ebx);
+    if (!arguments)
+    {
+        return ERROR(-EINVARG);
+    }
+
+    char path[VIOS_MAX_PATH];
+    strcpy(path, "0:/");
+    strncpy(path + 3, arguments->argument, sizeof(path) - 4);
+    path[sizeof(path) - 1] = 0;
+
+    struct process *process = 0;
+    int res = process_load(path, &process);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    res = process_inject_arguments(process, arguments);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    res = isr80h_spawn_inherit(task->process, (int)frame->ecx, process, PROCESS_FD_STDIN);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    res = isr80h_spawn_inherit(task->process, (int)frame->edx, process, PROCESS_FD_STDOUT);
+
+out:
+    if (res < 0)
+    {
+        process_terminate(process);
+        return ERROR(res);
+    }
+
+    // A child reading the console takes the keyboard over from a foreground parent,
+    // it goes back to the waiter once the child exits
+    if ((int)frame->ecx < 0 && task->process == process_current())
+    {
+        process_switch(process);
+    }
+
+    return (void *)(int)process->id;
+}
+
+void *isr80h_command41_process_wait(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = process id
+    struct task *task = task_current();
+    struct process *process = process_get((int)frame->ebx);
+    if (!process)
+    {
+        // Already gone
+        return 0;
+    }
+
+    if (process == task->process)
+    {
+        return ERROR(-EINVARG);
+    }
+
+    // Queued on this process itself, not its id, so a new process reusing the slot can't
+    // hold us up. process_free_process wakes us and the call returns 0 without running again.
+    wait_queue_block(&process->exit_waiters, task);
+    task->registers.eax = 0;
+    task_next();
+    return 0;
+}
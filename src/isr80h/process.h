@@ -6,5 +6,7 @@ void *isr80h_command6_proccess_load_start(struct interrupt_frame *frame);
 void *isr80h_command7_invoke_system_command(struct interrupt_frame *frame);
 void *isr80h_command8_get_program_arguments(struct interrupt_frame *frame);
 void *isr80h_command0_exit(struct interrupt_frame *frame);
+void *isr80h_command40_process_spawn(struct interrupt_frame *frame);
+void *isr80h_command41_process_wait(struct interrupt_frame *frame);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "ring.h"
+#include "task/syscall_ring.h"
+#include "task/task.h"
+#include "task/process.h"
+#include "idt/idt.h"
+#include "kernel.h"
+
+void *isr80h_command45_ring_setup(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = struct syscall_ring, a vios_malloc allocation of its own
+    return ERROR(syscall_ring_setup(task_current()->process, (void *)frame->ebx));
+}
+
+void *isr80h_command46_ring_enter(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = entries to submit, ECX = completions to wait for. Returns entries consumed
+    bool blocked = false;
+    int res = syscall_ring_enter(task_current()->process, frame->ebx, frame->ecx, &blocked);
+    if (blocked)
+    {
+        // The timer tick, or syscall_ring_poll while idle, stores the submit count in our EAX when it wakes us
+        task_next();
+    }
+
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
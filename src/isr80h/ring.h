@@ -0,0 +1,8 @@
+#ifndef ISR80H_RING_H
+#define ISR80H_RING_H
+
+struct interrupt_frame;
+void *isr80h_command45_ring_setup(struct interrupt_frame *frame);
+void *isr80h_command46_ring_enter(struct interrupt_frame *frame);
+
+#endif
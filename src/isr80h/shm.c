@@ -0,0 +1,41 @@
+#include "shm.h"
+#include "memory/shm/shm.h"
+#include "task/task.h"
+#include "task/process.h"
+#include "idt/idt.h"
+#include "kernel.h"
+
+void *isr80h_command42_shm_create(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = size, ECX = address to map at (0 lets the kernel pick)
+    // Returns the region id, the mapped address comes back in ECX
+    void *virt = 0;
+    int res = shm_create(task_current()->process, frame->ebx, (void *)frame->ecx, &virt);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    frame->ecx = (uint32_t)virt;
+    return (void *)res;
+}
+
+void *isr80h_command43_shm_map(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = region id, ECX = address to map at (0 lets the kernel pick)
+    // Returns the mapped address, which always lies below 0x80000000 so errors stay negative
+    void *virt = 0;
+    int res = shm_map(task_current()->process, (int)frame->ebx, (void *)frame->ecx, &virt);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return virt;
+}
+
+void *isr80h_command44_shm_unmap(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = mapped address
+    return ERROR(shm_unmap(task_current()->process, (void *)frame->ebx));
+}
@@ -0,0 +1,9 @@
+#ifndef ISR80H_SHM_H
+#define ISR80H_SHM_H
+
+struct interrupt_frame;
+void *isr80h_command42_shm_create(struct interrupt_frame *frame);
+void *isr80h_command43_shm_map(struct interrupt_frame *frame);
+void *isr80h_command44_shm_unmap(struct interrupt_frame *frame);
+
+#endif
@@ -0,0 +1,175 @@
+#include "trace.h"
+#include "task/task.h"
+#include "time/ktime.h"
+#include "sync/spinlock.h"
+#include "memory/memory.h"
+#include "memory/heap/kheap.h"
+#include "idt/idt.h"
+#include "status.h"
+#include "kernel.h"
+
+static struct isr80h_trace_stats isr80h_trace_table[ISR80H_TRACE_MAX_COMMANDS];
+static bool isr80h_tracing = false;
+static struct spinlock isr80h_trace_lock;
+
+void isr80h_trace_init()
+{
+    spinlock_init(&isr80h_trace_lock, "isr80h_trace");
+    isr80h_trace_reset();
+}
+
+void isr80h_trace_set_enabled(bool enabled)
+{
+    // Timestamps come from the TSC, without one there is nothing to measure
+    isr80h_tracing = enabled && ktime_tsc_available();
+}
+
+bool isr80h_trace_enabled()
+{
+    return isr80h_tracing;
+}
+
+void isr80h_trace_reset()
+{
+    uint32_t flags = spin_lock_irqsave(&isr80h_trace_lock);
+    memset(isr80h_trace_table, 0, sizeof(isr80h_trace_table));
+    for (int i = 0; i < ISR80H_TRACE_MAX_COMMANDS; i++)
+    {
+        isr80h_trace_table[i].command = i;
+    }
+    spin_unlock_irqrestore(&isr80h_trace_lock, flags);
+}
+
+uint64_t isr80h_trace_begin()
+{
+    return isr80h_tracing ? ktime_read_tsc() : 0;
+}
+
+static int isr80h_trace_bucket(uint64_t cycles)
+{
+    uint32_t high = (uint32_t)(cycles >> 32);
+    if (high)
+    {
+        return ISR80H_TRACE_BUCKETS - 1;
+    }
+
+    uint32_t low = (uint32_t)cycles;
+    return low ? 31 - __builtin_clz(low) : 0;
+}
+
+void isr80h_trace_end(int command, uint64_t start)
+{
+    if (!start || command < 0 || command >= ISR80H_TRACE_MAX_COMMANDS)
+    {
+        return;
+    }
+
+    uint64_t cycles = ktime_read_tsc() - start;
+    uint32_t flags = spin_lock_irqsave(&isr80h_trace_lock);
+    struct isr80h_trace_stats *stats = &isr80h_trace_table[command];
+    stats->calls++;
+    stats->total_cycles += cycles;
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+    stats->histogram[isr80h_trace_bucket(cycles)]++;
+    spin_unlock_irqrestore(&isr80h_trace_lock, flags);
+}
+
+bool isr80h_trace_get(int command, struct isr80h_trace_stats *stats)
+{
+    if (command < 0 || command >= ISR80H_TRACE_MAX_COMMANDS)
+    {
+        return false;
+    }
+
+    return isr80h_trace_snapshot(stats, command, 1) == 1;
+}
+
+int isr80h_trace_snapshot(struct isr80h_trace_stats *out, int first, int count)
+{
+    if (first < 0 || first >= ISR80H_TRACE_MAX_COMMANDS || count <= 0)
+    {
+        return 0;
+    }
+
+    if (count > ISR80H_TRACE_MAX_COMMANDS - first)
+    {
+        count = ISR80H_TRACE_MAX_COMMANDS - first;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&isr80h_trace_lock);
+    memcpy(out, &isr80h_trace_table[first], count * sizeof(struct isr80h_trace_stats));
+    spin_unlock_irqrestore(&isr80h_trace_lock, flags);
+    return count;
+}
+
+int isr80h_trace_median_bucket(const struct isr80h_trace_stats *stats)
+{
+    uint32_t seen = 0;
+    for (int i = 0; i < ISR80H_TRACE_BUCKETS; i++)
+    {
+        seen += stats->histogram[i];
+        if (seen * 2 >= stats->calls)
+        {
+            return i;
+        }
+    }
+
+    return ISR80H_TRACE_BUCKETS - 1;
+}
+
+void *isr80h_command48_syscall_trace(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = ISR80H_TRACE_OP_*, for reads ECX = struct isr80h_trace_stats array and EDX = entries
+    switch (frame->ebx)
+    {
+    case ISR80H_TRACE_OP_ENABLE:
+        isr80h_trace_set_enabled(true);
+        return isr80h_trace_enabled() ? 0 : ERROR(-EUNIMP);
+
+    case ISR80H_TRACE_OP_DISABLE:
+        isr80h_trace_set_enabled(false);
+        return 0;
+
+    case ISR80H_TRACE_OP_RESET:
+        isr80h_trace_reset();
+        return 0;
+
+    case ISR80H_TRACE_OP_READ:
+        break;
+
+    default:
+        return ERROR(-EINVARG);
+    }
+
+    int count = (int)frame->edx;
+    if (count <= 0)
+    {
+        return ERROR(-EINVARG);
+    }
+
+    if (count > ISR80H_TRACE_MAX_COMMANDS)
+    {
+        count = ISR80H_TRACE_MAX_COMMANDS;
+    }
+
+    // Snapshot under the lock so a concurrent trace_end can't tear entries, the lock isn't held across copy_to_task
+    struct isr80h_trace_stats *snapshot = kmalloc(count * sizeof(struct isr80h_trace_stats));
+    if (!snapshot)
+    {
+        return ERROR(-ENOMEM);
+    }
+
+    // Entry i describes command i
+    isr80h_trace_snapshot(snapshot, 0, count);
+    int res = copy_to_task(task_current(), (void *)frame->ecx, snapshot, count * sizeof(struct isr80h_trace_stats));
+    kfree(snapshot);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)count;
+}
@@ -0,0 +1,48 @@
+#ifndef ISR80H_TRACE_H
+#define ISR80H_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Commands above this id are dispatched but not traced
+#define ISR80H_TRACE_MAX_COMMANDS 64
+
+// Bucket i counts calls that took [2^i, 2^(i+1)) cycles
+#define ISR80H_TRACE_BUCKETS 32
+
+#define ISR80H_TRACE_OP_READ 0
+#define ISR80H_TRACE_OP_ENABLE 1
+#define ISR80H_TRACE_OP_DISABLE 2
+#define ISR80H_TRACE_OP_RESET 3
+
+struct isr80h_trace_stats
+{
+    uint32_t command;
+    uint32_t calls;
+    uint64_t total_cycles;
+    uint64_t max_cycles;
+    uint32_t histogram[ISR80H_TRACE_BUCKETS];
+};
+
+void isr80h_trace_init();
+void isr80h_trace_set_enabled(bool enabled);
+bool isr80h_trace_enabled();
+void isr80h_trace_reset();
+
+// Returns the start timestamp, zero when tracing is off
+uint64_t isr80h_trace_begin();
+void isr80h_trace_end(int command, uint64_t start);
+
+// Copies one command's stats, false for commands that aren't traced
+bool isr80h_trace_get(int command, struct isr80h_trace_stats *stats);
+
+// Consistent copy of up to count entries starting at command first, returns how many were copied
+int isr80h_trace_snapshot(struct isr80h_trace_stats *out, int first, int count);
+
+// Smallest bucket holding at least half of the command's calls
+int isr80h_trace_median_bucket(const struct isr80h_trace_stats *stats);
+
+struct interrupt_frame;
+void *isr80h_command48_syscall_trace(struct interrupt_frame *frame);
+
+#endif
@@ -3,10 +3,22 @@
 #include "task/task.h"
 #include "task/process.h"
 #include "graphics/graphics.h"
+#include "graphics/user_surface.h"
+#include "graphics/compositor.h"
 #include "kernel.h"
+#include "config.h"
+#include "status.h"
+#include "memory/heap/kheap.h"
 #include "idt/idt.h"
 #include <stdint.h>
 
+// The caller's selected window, or the back buffer when it has none
+static GraphicsSurface *vix_target(void)
+{
+    struct task *task = task_current();
+    return task ? compositor_target(task->process) : 0;
+}
+
 /**
  * Draws a single pixel at the specified coordinates with the given RGB color using the VIX Graphics API.
  *
@@ -28,9 +40,9 @@ void *isr80h_command11_vix_draw_pixel(struct interrupt_frame *frame)
     
     // Convert to graphics color and draw
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
-        graphics_set_pixel(ctx->back_buffer, x, y, color);
+    GraphicsSurface *target = vix_target();
+    if (target) {
+        graphics_set_pixel(target, x, y, color);
     }
     
     return 0;
@@ -57,10 +69,10 @@ void *isr80h_command12_vix_draw_rect(struct interrupt_frame *frame)
     
     // Convert to graphics color and draw
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
+    GraphicsSurface *target = vix_target();
+    if (target) {
         Rectangle rect = {x, y, width, height};
-        graphics_draw_rect(ctx->back_buffer, rect, color);
+        graphics_draw_rect(target, rect, color);
     }
     
     return 0;
@@ -89,10 +101,10 @@ void *isr80h_command13_vix_fill_rect(struct interrupt_frame *frame)
     
     // Convert to graphics color and fill
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
+    GraphicsSurface *target = vix_target();
+    if (target) {
         Rectangle rect = {x, y, width, height};
-        graphics_fill_rect(ctx->back_buffer, rect, color);
+        graphics_fill_rect(target, rect, color);
     }
     
     return 0;
@@ -116,9 +128,9 @@ void *isr80h_command14_vix_clear_screen(struct interrupt_frame *frame)
     
     // Convert to graphics color and clear
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
-        graphics_clear_surface(ctx->back_buffer, color);
+    GraphicsSurface *target = vix_target();
+    if (target) {
+        graphics_clear_surface(target, color);
     }
     
     return 0;
@@ -132,8 +144,8 @@ void *isr80h_command14_vix_clear_screen(struct interrupt_frame *frame)
  */
 void *isr80h_command15_vix_present_frame(struct interrupt_frame *frame)
 {
-    // No parameters - just present the current frame
-    graphics_present();
+    // No parameters - composite the windows and present the current frame
+    compositor_present();
     return 0;
 }
 
@@ -189,11 +201,11 @@ void *isr80h_command17_vix_draw_line(struct interrupt_frame *frame)
     
     // Convert to graphics color and draw
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
+    GraphicsSurface *target = vix_target();
+    if (target) {
         Point start = {x1, y1};
         Point end = {x2, y2};
-        graphics_draw_line(ctx->back_buffer, start, end, color);
+        graphics_draw_line(target, start, end, color);
     }
     
     return 0;
@@ -220,10 +232,10 @@ void *isr80h_command18_vix_draw_circle(struct interrupt_frame *frame)
     
     // Convert to graphics color and draw
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
+    GraphicsSurface *target = vix_target();
+    if (target) {
         Point center = {x, y};
-        graphics_draw_circle(ctx->back_buffer, center, radius, color);
+        graphics_draw_circle(target, center, radius, color);
     }
     
     return 0;
@@ -249,10 +261,10 @@ void *isr80h_command19_vix_fill_circle(struct interrupt_frame *frame)
     
     // Convert to graphics color and fill
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
+    GraphicsSurface *target = vix_target();
+    if (target) {
         Point center = {x, y};
-        graphics_fill_circle(ctx->back_buffer, center, radius, color);
+        graphics_fill_circle(target, center, radius, color);
     }
     
     return 0;
@@ -278,10 +290,10 @@ void *isr80h_command20_vix_draw_text(struct interrupt_frame *frame)
     
     // Convert to graphics color and draw text
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
+    GraphicsSurface *target = vix_target();
+    if (target) {
         Point position = {x, y};
-        graphics_draw_text(ctx->back_buffer, text, position, color);
+        graphics_draw_text(target, text, position, color);
     }
     
     return 0;
@@ -308,10 +320,10 @@ void *isr80h_command21_vix_draw_text_scaled(struct interrupt_frame *frame)
     
     // Convert to graphics color and draw scaled text
     Color color = graphics_rgb_to_color(r, g, b);
-    GraphicsContext *ctx = graphics_get_context();
-    if (ctx && ctx->back_buffer) {
+    GraphicsSurface *target = vix_target();
+    if (target) {
         Point position = {x, y};
-        graphics_draw_text_scaled(ctx->back_buffer, text, position, color, scale);
+        graphics_draw_text_scaled(target, text, position, color, scale);
     }
     
     return 0;
@@ -347,3 +359,203 @@ void *isr80h_command23_vix_text_height(struct interrupt_frame *frame)
     int height = graphics_text_height(scale);
     return (void *)height;
 }
+
+/**
+ * Maps an RGB565 surface into the calling process so it can draw with plain stores
+ * instead of a trap per primitive.
+ * @returns The user address of the pixels, or a negative status code.
+ */
+void *isr80h_command49_vix_surface_create(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = width, ECX = height
+    // Addresses come from the shared memory window below 0x80000000, so errors stay negative
+    void *virt = 0;
+    int res = user_surface_create(task_current()->process, (int)frame->ebx, (int)frame->ecx, &virt);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return virt;
+}
+
+/**
+ * Copies the calling process' surface into the back buffer in one call, optionally
+ * presenting the frame straight after.
+ */
+void *isr80h_command50_vix_surface_present(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = dest x, ECX = dest y, EDX = source rect pointer (0 for the whole surface),
+    // ESI = non-zero to present the frame as well
+    struct task *task = task_current();
+    struct user_surface_rect rect;
+    struct user_surface_rect *source = 0;
+    if (frame->edx)
+    {
+        int res = copy_from_task(task, &rect, (void *)frame->edx, sizeof(rect));
+        if (res < 0)
+        {
+            return ERROR(res);
+        }
+        source = &rect;
+    }
+
+    int res = user_surface_present(task->process, source, (int)frame->ebx, (int)frame->ecx);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    if (frame->esi)
+    {
+        compositor_present();
+    }
+
+    return 0;
+}
+
+static Color vix_color(uint32_t rgb)
+{
+    return graphics_rgb_to_color((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+}
+
+// Runs one record against surface, false when it is malformed
+static bool vix_run_command(struct process *process, GraphicsSurface *surface, const struct vix_command_header *header)
+{
+    switch (header->op)
+    {
+    case VIX_CMD_CLEAR:
+    {
+        const struct vix_command_clear *cmd = (const void *)header;
+        if (header->size < sizeof(*cmd))
+            return false;
+        graphics_clear_surface(surface, vix_color(cmd->color));
+        return true;
+    }
+
+    case VIX_CMD_FILL_RECT:
+    case VIX_CMD_DRAW_RECT:
+    {
+        const struct vix_command_rect *cmd = (const void *)header;
+        if (header->size < sizeof(*cmd))
+            return false;
+        Rectangle rect = {cmd->x, cmd->y, cmd->width, cmd->height};
+        if (header->op == VIX_CMD_FILL_RECT)
+            graphics_fill_rect(surface, rect, vix_color(cmd->color));
+        else
+            graphics_draw_rect(surface, rect, vix_color(cmd->color));
+        return true;
+    }
+
+    case VIX_CMD_DRAW_LINE:
+    {
+        const struct vix_command_line *cmd = (const void *)header;
+        if (header->size < sizeof(*cmd))
+            return false;
+        graphics_draw_line(surface, (Point){cmd->x1, cmd->y1}, (Point){cmd->x2, cmd->y2}, vix_color(cmd->color));
+        return true;
+    }
+
+    case VIX_CMD_DRAW_CIRCLE:
+    case VIX_CMD_FILL_CIRCLE:
+    {
+        const struct vix_command_circle *cmd = (const void *)header;
+        if (header->size < sizeof(*cmd))
+            return false;
+        Point center = {cmd->x, cmd->y};
+        if (header->op == VIX_CMD_FILL_CIRCLE)
+            graphics_fill_circle(surface, center, cmd->radius, vix_color(cmd->color));
+        else
+            graphics_draw_circle(surface, center, cmd->radius, vix_color(cmd->color));
+        return true;
+    }
+
+    case VIX_CMD_DRAW_TEXT:
+    {
+        // The text lives inside the record, so it must end inside it too
+        const struct vix_command_text *cmd = (const void *)header;
+        if (header->size < sizeof(*cmd) || header->size < sizeof(*cmd) + cmd->length + 1 ||
+            cmd->text[cmd->length] != '\0' || cmd->scale == 0)
+            return false;
+        graphics_draw_text_scaled(surface, cmd->text, (Point){cmd->x, cmd->y}, vix_color(cmd->color), cmd->scale);
+        return true;
+    }
+
+    case VIX_CMD_BLIT:
+    {
+        const struct vix_command_blit *cmd = (const void *)header;
+        if (header->size < sizeof(*cmd))
+            return false;
+        struct user_surface_rect rect = {cmd->src_x, cmd->src_y, cmd->width, cmd->height};
+        return user_surface_present(process, &rect, cmd->x, cmd->y) == 0;
+    }
+
+    case VIX_CMD_PRESENT:
+        compositor_present();
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Runs a buffer of VIX drawing records with one trap, against the caller's drawing target.
+ * The buffer is copied into the kernel once and decoded in order, text travels inside the
+ * records so nothing else is read from user memory.
+ * @returns The number of records run, or -EINVARG at the first malformed record.
+ */
+void *isr80h_command51_vix_submit(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = command buffer, ECX = size in bytes
+    int size = (int)frame->ecx;
+    if (size <= 0 || size > VIOS_MAX_VIX_COMMAND_BYTES)
+    {
+        return ERROR(-EINVARG);
+    }
+
+    struct task *task = task_current();
+    GraphicsSurface *target = compositor_target(task->process);
+    if (!target)
+    {
+        return ERROR(-EIO);
+    }
+
+    uint8_t *buffer = kmalloc(size);
+    if (!buffer)
+    {
+        return ERROR(-ENOMEM);
+    }
+
+    int res = copy_from_task(task, buffer, (void *)frame->ebx, size);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    int count = 0;
+    int offset = 0;
+    while (offset < size)
+    {
+        const struct vix_command_header *header = (const void *)&buffer[offset];
+        if (size - offset < (int)sizeof(*header) || header->size < sizeof(*header) ||
+            header->size % 4 || header->size > size - offset ||
+            !vix_run_command(task->process, target, header))
+        {
+            res = -EINVARG;
+            goto out;
+        }
+
+        offset += header->size;
+        count++;
+    }
+    res = count;
+
+out:
+    kfree(buffer);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
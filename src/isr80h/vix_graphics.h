@@ -24,6 +24,80 @@ struct vix_screen_info {
 #define VIX_COLOR_CYAN VIX_RGB(0, 255, 255)
 #define VIX_COLOR_MAGENTA VIX_RGB(255, 0, 255)
 
+// Command buffer records, see isr80h_command51_vix_submit
+enum vix_command_op
+{
+    VIX_CMD_CLEAR = 1,
+    VIX_CMD_FILL_RECT,
+    VIX_CMD_DRAW_RECT,
+    VIX_CMD_DRAW_LINE,
+    VIX_CMD_DRAW_CIRCLE,
+    VIX_CMD_FILL_CIRCLE,
+    VIX_CMD_DRAW_TEXT,
+    VIX_CMD_BLIT,
+    VIX_CMD_PRESENT,
+};
+
+// Every record starts with this, size covers the header and is a multiple of four bytes
+struct vix_command_header
+{
+    uint16_t op;
+    uint16_t size;
+};
+
+struct vix_command_clear
+{
+    struct vix_command_header header;
+    uint32_t color;
+};
+
+// FILL_RECT and DRAW_RECT
+struct vix_command_rect
+{
+    struct vix_command_header header;
+    int16_t x, y;
+    int16_t width, height;
+    uint32_t color;
+};
+
+struct vix_command_line
+{
+    struct vix_command_header header;
+    int16_t x1, y1;
+    int16_t x2, y2;
+    uint32_t color;
+};
+
+// DRAW_CIRCLE and FILL_CIRCLE
+struct vix_command_circle
+{
+    struct vix_command_header header;
+    int16_t x, y;
+    int16_t radius;
+    int16_t reserved;
+    uint32_t color;
+};
+
+// The text follows inline, length characters then a NUL, padded up to the record size
+struct vix_command_text
+{
+    struct vix_command_header header;
+    int16_t x, y;
+    uint16_t scale;
+    uint16_t length;
+    uint32_t color;
+    char text[];
+};
+
+// Copies part of the process' surface (see vix_surface_create) into the back buffer
+struct vix_command_blit
+{
+    struct vix_command_header header;
+    int16_t src_x, src_y;
+    int16_t width, height;
+    int16_t x, y;
+};
+
 // VIX Graphics API system call handlers
 void *isr80h_command11_vix_draw_pixel(struct interrupt_frame *frame);
 void *isr80h_command12_vix_draw_rect(struct interrupt_frame *frame);
@@ -38,5 +112,8 @@ void *isr80h_command20_vix_draw_text(struct interrupt_frame *frame);
 void *isr80h_command21_vix_draw_text_scaled(struct interrupt_frame *frame);
 void *isr80h_command22_vix_text_width(struct interrupt_frame *frame);
 void *isr80h_command23_vix_text_height(struct interrupt_frame *frame);
+void *isr80h_command49_vix_surface_create(struct interrupt_frame *frame);
+void *isr80h_command50_vix_surface_present(struct interrupt_frame *frame);
+void *isr80h_command51_vix_submit(struct interrupt_frame *frame);
 
 #endif // VIX_GRAPHICS_H
@@ -0,0 +1,49 @@
+#include "window.h"
+#include "graphics/compositor.h"
+#include "task/task.h"
+#include "task/process.h"
+#include "idt/idt.h"
+#include "status.h"
+#include "kernel.h"
+
+void *isr80h_command52_window_create(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = x, ECX = y, EDX = width, ESI = height
+    // Returns the window id, VIX drawing from the caller goes into the new window from now on
+    Rectangle rect = {(int)frame->ebx, (int)frame->ecx, (int)frame->edx, (int)frame->esi};
+    int res = compositor_window_create(task_current()->process, rect);
+    if (res < 0)
+    {
+        return ERROR(res);
+    }
+
+    return (void *)res;
+}
+
+void *isr80h_command53_window_control(struct interrupt_frame *frame)
+{
+    // Parameters: EBX = window id, ECX = operation, EDX = x, ESI = y (x and y only for a move)
+    struct process *process = task_current()->process;
+    int window_id = (int)frame->ebx;
+    int res = -EINVARG;
+    switch (frame->ecx)
+    {
+    case COMPOSITOR_WINDOW_DESTROY:
+        res = compositor_window_destroy(process, window_id);
+        break;
+
+    case COMPOSITOR_WINDOW_MOVE:
+        res = compositor_window_move(process, window_id, (int)frame->edx, (int)frame->esi);
+        break;
+
+    case COMPOSITOR_WINDOW_RAISE:
+        res = compositor_window_raise(process, window_id);
+        break;
+
+    case COMPOSITOR_WINDOW_SELECT:
+        res = compositor_window_select(process, window_id);
+        break;
+    }
+
+    return ERROR(res);
+}
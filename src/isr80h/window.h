@@ -0,0 +1,8 @@
+#ifndef ISR80H_WINDOW_H
+#define ISR80H_WINDOW_H
+
+struct interrupt_frame;
+void *isr80h_command52_window_create(struct interrupt_frame *frame);
+void *isr80h_command53_window_control(struct interrupt_frame *frame);
+
+#endif
@@ -6,6 +6,7 @@
 #include "../fs/file.h"
 #include "../disk/disk.h"
 #include "../idt/idt.h"
+#include "../irq/irq.h"
 #include "../task/tss.h"
 #include "../task/process.h"
 #include "../task/task.h"
@@ -16,12 +17,23 @@
 #include "../panic/panic.h"
 #include "../graphics/graphics.h"
 #include "../graphics/vix_kernel.h"
+#include "../graphics/compositor.h"
+#include "../graphics/cursor.h"
 #include "../audio/audio.h"
 #include "../mouse/ps2_mouse.h"
 #include "../io/io.h"
 #include "../config.h"
 #include "../string/string.h"
 #include "../debug/simple_serial.h"
+#include "../cpu/cpu.h"
+#include "../task/sched.h"
+#include "../task/fpu.h"
+#include "../sync/futex.h"
+#include "../task/ipc.h"
+#include "../memory/shm/shm.h"
+#include "../task/syscall_ring.h"
+#include "../time/ktime.h"
+#include "../time/vclock.h"
 
 // External declarations
 extern struct tss tss;
@@ -67,6 +79,7 @@ void kernel_init_paging(void)
     }
     paging_switch(kernel_chunk);
     enable_paging();
+    paging_init_pat();
 }
 
 void kernel_init_devices(void)
@@ -75,6 +88,17 @@ void kernel_init_devices(void)
     kheap_init();
     simple_serial_puts("  Heap initialized\n");
     
+    simple_serial_puts("  Initializing CPUs and scheduler...\n");
+    cpu_init();
+    sched_init();
+    task_list_init();
+    futex_init();
+    ipc_init();
+    shm_init();
+    compositor_init();
+    syscall_ring_init();
+    simple_serial_puts("  Scheduler initialized\n");
+    
     simple_serial_puts("  Initializing filesystem...\n");
     fs_init();
     simple_serial_puts("  Filesystem initialized\n");
@@ -88,6 +112,20 @@ void kernel_init_devices(void)
     idt_init();
     simple_serial_puts("  IDT initialized\n");
     
+    simple_serial_puts("  Initializing interrupt controller...\n");
+    irq_init();
+    simple_serial_puts("  Interrupt controller initialized\n");
+    
+    simple_serial_puts("  Initializing FPU...\n");
+    fpu_init();
+    memory_init();
+    simple_serial_puts("  FPU initialized\n");
+    
+    simple_serial_puts("  Initializing clocksource...\n");
+    ktime_init();
+    vclock_init();
+    simple_serial_puts("  Clocksource initialized\n");
+    
     simple_serial_puts("  Initializing keyboard...\n");
     keyboard_init();
     simple_serial_puts("  Keyboard initialized\n");
@@ -120,6 +158,9 @@ struct mouse *kernel_init_graphics(void)
         panic("Failed to initialize graphics system");
     }
 
+    cursor_move(mouse->x, mouse->y);
+    cursor_show(true);
+
     return mouse;
 }
 
@@ -133,7 +174,5 @@ void kernel_display_boot_message(void)
 
 void kernel_unmask_timer_irq(void)
 {
-    uint8_t mask = inb(0x21);
-    mask &= ~0x01; // Unmask IRQ0 (timer)
-    outb(0x21, mask);
+    ktime_enable_tick();
 }
@@ -33,7 +33,7 @@ struct mouse *kernel_init_graphics(void);
 void kernel_display_boot_message(void);
 
 /**
- * Enable PIC timer IRQ0
+ * Enable the timer tick, IRQ0 on the PIC or the LAPIC timer
  */
 void kernel_unmask_timer_irq(void);
 
@@ -9,6 +9,10 @@
 #include "../debug/simple_serial.h"
 #include "../terminal/terminal.h"
 #include "../io/io.h"
+#include "../sync/lockstat.h"
+#include "../isr80h/trace.h"
+#include "../math/div64.h"
+#include "../idt/softirq.h"
 
 // Simple kernel terminal state
 static char terminal_buffer[80 * 25]; // 80 columns, 25 rows
@@ -69,25 +73,65 @@ void kernel_terminal_print(const char* str)
     }
 }
 
+// What is on screen, so a render only touches the cells that changed since the last one
+static char rendered_buffer[80 * 25];
+static int rendered_cursor_x = -1;
+static int rendered_cursor_y = -1;
+static int rendered_bg_color = -1;
+
+static void kernel_terminal_draw_cell(int x, int y)
+{
+    vix_kernel_fill_rect(x * 8, y * 16, 8, 16, terminal_bg_color);
+
+    char c = terminal_buffer[y * 80 + x];
+    if (c != ' ') {
+        char str[2] = {c, '\0'};
+        vix_kernel_draw_text(str, x * 8, y * 16, VIX_COLOR_WHITE);
+    }
+    rendered_buffer[y * 80 + x] = c;
+}
+
 void kernel_terminal_render()
 {
-    // Clear screen
-    vix_kernel_clear_screen(terminal_bg_color);
-    
-    // Draw terminal content
+    bool changed = false;
+
+    if (rendered_bg_color != terminal_bg_color) {
+        // New background, everything has to be drawn again
+        vix_kernel_clear_screen(terminal_bg_color);
+        for (int i = 0; i < 80 * 25; i++) {
+            rendered_buffer[i] = ' ';
+        }
+        rendered_bg_color = terminal_bg_color;
+        rendered_cursor_x = -1;
+        changed = true;
+    }
+
+    // Blank cells are already background after a clear, so only differing ones are drawn
     for (int y = 0; y < 25; y++) {
         for (int x = 0; x < 80; x++) {
-            char c = terminal_buffer[y * 80 + x];
-            if (c != ' ') {
-                char str[2] = {c, '\0'};
-                vix_kernel_draw_text(str, x * 8, y * 16, VIX_COLOR_WHITE);
+            if (terminal_buffer[y * 80 + x] != rendered_buffer[y * 80 + x]) {
+                kernel_terminal_draw_cell(x, y);
+                changed = true;
             }
         }
     }
-    
-    // Draw cursor
+
+    if (cursor_x != rendered_cursor_x || cursor_y != rendered_cursor_y) {
+        if (rendered_cursor_x >= 0 && rendered_cursor_x < 80 && rendered_cursor_y >= 0 && rendered_cursor_y < 25) {
+            kernel_terminal_draw_cell(rendered_cursor_x, rendered_cursor_y);
+        }
+        rendered_cursor_x = cursor_x;
+        rendered_cursor_y = cursor_y;
+        changed = true;
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    // Redrawn cells under the cursor wipe it, so it goes back on whenever anything changed
     vix_kernel_fill_rect(cursor_x * 8, cursor_y * 16, 8, 16, VIX_RGB(128, 128, 128));
-    
+
     vix_kernel_present_frame();
 }
 
@@ -99,6 +143,36 @@ void kernel_terminal_execute_command(const char* cmd)
         kernel_terminal_print("  clear - Clear screen\n");
         kernel_terminal_print("  echo <text> - Echo text\n");
         kernel_terminal_print("  bgcolor <color> - Change background (red/green/blue/black)\n");
+        kernel_terminal_print("  locks - Show lock contention counters\n");
+        kernel_terminal_print("  syscalls [on|off|reset] - Show or control system call tracing\n");
+    } else if (strncmp(cmd, "locks", 5) == 0) {
+        char line[80];
+        for (int i = 0; i < lockstat_count(); i++) {
+            const struct lock_stats *stats = lockstat_get(i);
+            snprintf(line, sizeof(line), "  %s: %d acq, %d contended, %d spins\n", stats->name, (int)stats->acquisitions, (int)stats->contentions, (int)stats->spins);
+            kernel_terminal_print(line);
+        }
+    } else if (strncmp(cmd, "syscalls on", 11) == 0) {
+        isr80h_trace_set_enabled(true);
+        kernel_terminal_print(isr80h_trace_enabled() ? "Syscall tracing on\n" : "No TSC, tracing unavailable\n");
+    } else if (strncmp(cmd, "syscalls off", 12) == 0) {
+        isr80h_trace_set_enabled(false);
+        kernel_terminal_print("Syscall tracing off\n");
+    } else if (strncmp(cmd, "syscalls reset", 14) == 0) {
+        isr80h_trace_reset();
+    } else if (strncmp(cmd, "syscalls", 8) == 0) {
+        char line[96];
+        kernel_terminal_print(isr80h_trace_enabled() ? "  cmd: calls, avg/max cycles, median < 2^n\n" : "  Tracing is off, use 'syscalls on'\n");
+        for (int i = 0; i < ISR80H_TRACE_MAX_COMMANDS; i++) {
+            struct isr80h_trace_stats stats;
+            if (!isr80h_trace_get(i, &stats) || !stats.calls) {
+                continue;
+            }
+            uint64_t max = stats.max_cycles > 0x7fffffff ? 0x7fffffff : stats.max_cycles;
+            snprintf(line, sizeof(line), "  %d: %d calls, %d avg, %d max, median < 2^%d\n", i, (int)stats.calls,
+                     (int)div_u64(stats.total_cycles, stats.calls), (int)max, isr80h_trace_median_bucket(&stats) + 1);
+            kernel_terminal_print(line);
+        }
     } else if (strncmp(cmd, "clear", 5) == 0) {
         kernel_terminal_clear();
     } else if (strncmp(cmd, "echo ", 5) == 0) {
@@ -132,6 +206,8 @@ void kernel_run_main_loop(struct mouse *mouse)
     input_pos = 0;
     
     while (1) {
+        // Pick up deferred interrupt work that was raised while a drain was already running
+        softirq_run();
         kernel_terminal_render();
         
         // Simple keyboard polling (direct port access)
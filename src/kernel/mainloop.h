@@ -9,4 +9,10 @@ struct mouse;
  */
 void kernel_run_main_loop(struct mouse *mouse);
 
+/**
+ * Write to the kernel terminal, used for console descriptors
+ */
+void kernel_terminal_putchar(char c);
+void kernel_terminal_print(const char *str);
+
 #endif // KERNEL_MAINLOOP_H
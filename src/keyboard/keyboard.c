@@ -4,12 +4,22 @@
 #include "task/process.h"
 #include "task/task.h"
 #include "ps2_keyboard.h"
+#include "sync/spinlock.h"
+#include "sync/waitqueue.h"
 
 static struct keyboard *keyboard_list_head = 0;
 static struct keyboard *keyboard_list_last = 0;
 
+// Guards the per-process key rings, pushed from IRQ1 and popped from syscalls
+static struct spinlock keyboard_ring_lock;
+
+// Tasks in keyboard_read with nothing to read, woken by every key
+static struct wait_queue keyboard_waiters;
+
 void keyboard_init()
 {
+    spinlock_init(&keyboard_ring_lock, "keyboard_ring");
+    wait_queue_init(&keyboard_waiters);
     keyboard_insert(classic_init());
 }
 
@@ -55,9 +65,11 @@ KEYBOARD_CAPS_LOCK_STATE keyboard_get_caps_lock(struct keyboard *keyboard)
 
 void keyboard_backspace(struct process *process)
 {
+    uint32_t flags = spin_lock_irqsave(&keyboard_ring_lock);
     process->keyboard.tail -= 1;
     int real_index = keyboard_get_tail_index(process);
     process->keyboard.buffer[real_index] = 0x00;
+    spin_unlock_irqrestore(&keyboard_ring_lock, flags);
 }
 
 void keyboard_push(char c)
@@ -73,9 +85,13 @@ void keyboard_push(char c)
         return;
     }
 
+    uint32_t flags = spin_lock_irqsave(&keyboard_ring_lock);
     int real_index = keyboard_get_tail_index(process);
     process->keyboard.buffer[real_index] = c;
     process->keyboard.tail++;
+    spin_unlock_irqrestore(&keyboard_ring_lock, flags);
+
+    wait_queue_wake_all(&keyboard_waiters);
 }
 
 char keyboard_pop()
@@ -86,15 +102,50 @@ char keyboard_pop()
     }
 
     struct process *process = task_current()->process;
+    uint32_t flags = spin_lock_irqsave(&keyboard_ring_lock);
     int real_index = process->keyboard.head % sizeof(process->keyboard.buffer);
     char c = process->keyboard.buffer[real_index];
-    if (c == 0x00)
+    if (c != 0x00)
     {
-        // Nothing to pop return zero.
-        return 0;
+        process->keyboard.buffer[real_index] = 0;
+        process->keyboard.head++;
     }
+    spin_unlock_irqrestore(&keyboard_ring_lock, flags);
 
-    process->keyboard.buffer[real_index] = 0;
-    process->keyboard.head++;
+    // Zero when there was nothing to pop
     return c;
 }
+
+int keyboard_read(struct task *task, char *buf, int size)
+{
+    if (size <= 0)
+    {
+        return 0;
+    }
+
+    struct process *process = task->process;
+    int total = 0;
+    uint32_t flags = spin_lock_irqsave(&keyboard_ring_lock);
+    while (total < size)
+    {
+        int real_index = process->keyboard.head % sizeof(process->keyboard.buffer);
+        char c = process->keyboard.buffer[real_index];
+        if (c == 0x00)
+        {
+            break;
+        }
+
+        process->keyboard.buffer[real_index] = 0;
+        process->keyboard.head++;
+        buf[total++] = c;
+    }
+
+    if (total == 0)
+    {
+        // Queued under the ring lock so a key pushed in between can't be missed
+        wait_queue_block(&keyboard_waiters, task);
+        total = -EAGAIN;
+    }
+    spin_unlock_irqrestore(&keyboard_ring_lock, flags);
+    return total;
+}
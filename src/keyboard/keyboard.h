@@ -7,6 +7,7 @@
 typedef int KEYBOARD_CAPS_LOCK_STATE;
 
 struct process;
+struct task;
 
 typedef int (*KEYBOARD_INIT_FUNCTION)();
 struct keyboard
@@ -23,6 +24,12 @@ void keyboard_init();
 void keyboard_backspace(struct process *process);
 void keyboard_push(char c);
 char keyboard_pop();
+
+/**
+ * Moves up to size pending keys of the task's process into buf. With none pending the task is
+ * queued until the next key arrives and -EAGAIN is returned, the caller then schedules away.
+ */
+int keyboard_read(struct task *task, char *buf, int size);
 int keyboard_insert(struct keyboard *keyboard);
 void keyboard_set_caps_lock(struct keyboard *keyboard, KEYBOARD_CAPS_LOCK_STATE state);
 KEYBOARD_CAPS_LOCK_STATE keyboard_get_caps_lock(struct keyboard *keyboard);
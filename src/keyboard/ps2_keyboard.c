@@ -3,6 +3,8 @@
 #include "io/io.h"
 #include "kernel.h"
 #include "idt/idt.h"
+#include "idt/softirq.h"
+#include "irq/irq.h"
 #include "task/task.h"
 
 #include <stdint.h>
@@ -17,6 +19,12 @@ static const size_t shift_keys_count = sizeof(shift_keys) / sizeof(shift_keys[0]
 
 static bool shift_down = false;
 
+// Characters decoded by the top half, waiting for the bottom half to reach the process' buffer
+#define CLASSIC_KEYBOARD_PENDING_SIZE 32
+static volatile uint8_t pending_keys[CLASSIC_KEYBOARD_PENDING_SIZE];
+static volatile uint32_t pending_head = 0;
+static volatile uint32_t pending_tail = 0;
+
 static uint8_t keyboard_scan_set_one[] = {
     0x00, 0x1B, '1', '2', '3', '4', '5',
     '6', '7', '8', '9', '0', '-', '=',
@@ -33,7 +41,10 @@ static uint8_t keyboard_scan_set_one[] = {
 
 int classic_keyboard_init();
 uint8_t classic_keyboard_scancode_to_char(uint8_t scancode);
-void classic_keyboard_handle_interrupt();
+int classic_keyboard_handle_interrupt(struct interrupt_frame *frame);
+void classic_keyboard_deliver_keys(void *data);
+
+static struct softirq_work classic_keyboard_work;
 
 struct keyboard classic_keyboard = {
     .name = {"Classic"},
@@ -62,17 +73,14 @@ void set_keyboard_leds(bool caps, bool num, bool scroll)
 
 int classic_keyboard_init()
 {
-    idt_register_interrupt_callback(ISR_KEYBOARD_INTERRUPT, classic_keyboard_handle_interrupt);
+    softirq_work_init(&classic_keyboard_work, classic_keyboard_deliver_keys, 0);
+    idt_register_fast_interrupt_callback(ISR_KEYBOARD_INTERRUPT, classic_keyboard_handle_interrupt);
     keyboard_set_caps_lock(&classic_keyboard, KEYBOARD_CAPS_LOCK_OFF);
     outb(PS2_PORT, PS2_COMMAND_ENABLE_FIRST_PORT);
     set_keyboard_leds(false, false, false);
     keyboard_set_caps_lock(&classic_keyboard, KEYBOARD_CAPS_LOCK_OFF);
 
-    // Enable IRQ 1 (keyboard) and IRQ 2 (cascade to slave PIC) on the master PIC
-    uint8_t mask = insb(0x21);
-    mask &= ~(1 << 1); // Clear bit 1 for IRQ 1 (keyboard)
-    mask &= ~(1 << 2); // Clear bit 2 for IRQ 2 (cascade to slave PIC)
-    outb(0x21, mask);
+    irq_unmask(IRQ_KEYBOARD);
     return 0;
 }
 
@@ -93,7 +101,8 @@ uint8_t classic_keyboard_scancode_to_char(uint8_t scancode)
     return c;
 }
 
-void classic_keyboard_handle_interrupt()
+// Top half, key releases and modifiers are handled without leaving the interrupted address space
+int classic_keyboard_handle_interrupt(struct interrupt_frame *frame)
 {
     uint8_t scancode = insb(KEYBOARD_INPUT_PORT);
     insb(KEYBOARD_INPUT_PORT); // discard extra byte if needed
@@ -110,7 +119,7 @@ void classic_keyboard_handle_interrupt()
                 shift_down = false;
             }
         }
-        return;
+        return IDT_IRQ_HANDLED;
     }
 
     if (scancode == CLASSIC_KEYBOARD_CAPS_LOCK)
@@ -128,9 +137,24 @@ void classic_keyboard_handle_interrupt()
     }
 
     uint8_t c = classic_keyboard_scancode_to_char(scancode);
-    if (c != 0)
+    if (c == 0 || pending_tail - pending_head >= CLASSIC_KEYBOARD_PENDING_SIZE)
+    {
+        return IDT_IRQ_HANDLED;
+    }
+
+    pending_keys[pending_tail % CLASSIC_KEYBOARD_PENDING_SIZE] = c;
+    pending_tail++;
+    softirq_raise(&classic_keyboard_work);
+    return IDT_IRQ_HANDLED;
+}
+
+// Deferred work, runs on the kernel page tables where the process' keyboard buffer lives
+void classic_keyboard_deliver_keys(void *data)
+{
+    while (pending_head != pending_tail)
     {
-        keyboard_push(c);
+        keyboard_push(pending_keys[pending_head % CLASSIC_KEYBOARD_PENDING_SIZE]);
+        pending_head++;
     }
 }
 
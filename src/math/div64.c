@@ -0,0 +1,31 @@
+#include "div64.h"
+
+uint64_t div_u64_rem(uint64_t dividend, uint32_t divisor, uint32_t *remainder)
+{
+    uint32_t high = (uint32_t)(dividend >> 32);
+    uint32_t low = (uint32_t)dividend;
+    uint32_t quotient_high = 0;
+    uint32_t quotient_low;
+    uint32_t rem;
+
+    // Divide the high word first so the second divl can't overflow
+    if (high >= divisor)
+    {
+        quotient_high = high / divisor;
+        high = high % divisor;
+    }
+
+    __asm__("divl %4" : "=a"(quotient_low), "=d"(rem) : "a"(low), "d"(high), "rm"(divisor));
+
+    if (remainder)
+    {
+        *remainder = rem;
+    }
+
+    return ((uint64_t)quotient_high << 32) | quotient_low;
+}
+
+uint64_t div_u64(uint64_t dividend, uint32_t divisor)
+{
+    return div_u64_rem(dividend, divisor, 0);
+}
@@ -0,0 +1,10 @@
+#ifndef DIV64_H
+#define DIV64_H
+
+#include <stdint.h>
+
+// 64-bit by 32-bit division without libgcc, done as two divl steps
+uint64_t div_u64_rem(uint64_t dividend, uint32_t divisor, uint32_t *remainder);
+uint64_t div_u64(uint64_t dividend, uint32_t divisor);
+
+#endif
@@ -3,7 +3,8 @@
 
 #define PI_F_32B 3.14159265358979323846f
 
-// Basic floating point math using FPU
+// Basic floating point math using FPU. Kernel callers must wrap the floating point
+// functions in fpu_kernel_begin/fpu_kernel_end, see task/fpu.h. min, max and abs are integer only.
 
 // Adds two doubles
 double fpu_add(double a, double b);
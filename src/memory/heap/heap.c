@@ -38,6 +38,7 @@ int heap_create(struct heap *heap, void *ptr, void *end, struct heap_table *tabl
     memset(heap, 0, sizeof(struct heap));
     heap->saddr = ptr;
     heap->table = table;
+    spinlock_init(&heap->lock, "heap");
 
     res = heap_validate_table(ptr, end, table);
     if (res < 0)
@@ -172,10 +173,16 @@ void *heap_malloc(struct heap *heap, size_t size)
 {
     size_t aligned_size = heap_align_value_to_upper(size);
     uint32_t total_blocks = aligned_size / VIOS_HEAP_BLOCK_SIZE;
-    return heap_malloc_blocks(heap, total_blocks);
+
+    uint32_t flags = spin_lock_irqsave(&heap->lock);
+    void *ptr = heap_malloc_blocks(heap, total_blocks);
+    spin_unlock_irqrestore(&heap->lock, flags);
+    return ptr;
 }
 
 void heap_free(struct heap *heap, void *ptr)
 {
+    uint32_t flags = spin_lock_irqsave(&heap->lock);
     heap_mark_blocks_free(heap, heap_address_to_block(heap, ptr));
+    spin_unlock_irqrestore(&heap->lock, flags);
 }
\ No newline at end of file
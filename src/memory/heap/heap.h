@@ -1,6 +1,7 @@
 #ifndef HEAP_H
 #define HEAP_H
 #include "config.h"
+#include "sync/spinlock.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -24,6 +25,9 @@ struct heap
 
     // Start address of the heap data pool
     void *saddr;
+
+    // Protects the block table, taken with interrupts disabled
+    struct spinlock lock;
 };
 
 int heap_create(struct heap *heap, void *ptr, void *end, struct heap_table *table);
@@ -1,12 +1,46 @@
 #include "memory.h"
+#include "cpu/cpu.h"
+#include "task/fpu.h"
+
+// SSE2 streaming stores, only once fpu_init has enabled OSFXSR
+static bool memory_use_sse2 = false;
+
+void memory_init()
+{
+    memory_use_sse2 = cpu_get_features()->sse2 && (cpu_read_cr4() & CPU_CR4_OSFXSR);
+}
 
 void *memset(void *ptr, int c, size_t size)
 {
-    char *c_ptr = (char *)ptr;
-    for (int i = 0; i < size; i++)
+    uint32_t pattern = (uint8_t)c;
+    pattern |= pattern << 8;
+    pattern |= pattern << 16;
+
+    void *d = ptr;
+    size_t dwords = size / 4;
+    size_t bytes = size % 4;
+    __asm__ __volatile__("rep stosl" : "+D"(d), "+c"(dwords) : "a"(pattern) : "memory");
+    __asm__ __volatile__("rep stosb" : "+D"(d), "+c"(bytes) : "a"(pattern) : "memory");
+    return ptr;
+}
+
+void *memset16(void *ptr, uint16_t value, size_t count)
+{
+    void *d = ptr;
+
+    // One lone pixel first when needed so the bulk of the fill is dword aligned
+    if (count && ((uintptr_t)d & 2))
     {
-        c_ptr[i] = (char)c;
+        *(uint16_t *)d = value;
+        d = (uint16_t *)d + 1;
+        count--;
     }
+
+    uint32_t pattern = ((uint32_t)value << 16) | value;
+    size_t dwords = count / 2;
+    size_t words = count % 2;
+    __asm__ __volatile__("rep stosl" : "+D"(d), "+c"(dwords) : "a"(pattern) : "memory");
+    __asm__ __volatile__("rep stosw" : "+D"(d), "+c"(words) : "a"(pattern) : "memory");
     return ptr;
 }
 
@@ -27,11 +61,111 @@ int memcmp(void *s1, void *s2, int count)
 
 void *memcpy(void *dest, void *src, int len)
 {
-    char *d = dest;
-    char *s = src;
-    while (len--)
+    if (len <= 0)
+    {
+        return dest;
+    }
+
+    // Forward copy, same overlap behaviour as the byte loop it replaces
+    void *d = dest;
+    void *s = src;
+    size_t dwords = len / 4;
+    size_t bytes = len % 4;
+    __asm__ __volatile__("rep movsl" : "+D"(d), "+S"(s), "+c"(dwords) : : "memory");
+    __asm__ __volatile__("rep movsb" : "+D"(d), "+S"(s), "+c"(bytes) : : "memory");
+    return dest;
+}
+
+// The kernel is built without SSE, the compiler never keeps values in xmm registers so
+// these blocks don't list them as clobbers. Destinations are 16 byte aligned.
+static void memory_copy_nt_sse2(void *dest, const void *src, size_t blocks)
+{
+    __asm__ __volatile__(
+        "1:\n\t"
+        "movdqu (%1), %%xmm0\n\t"
+        "movdqu 16(%1), %%xmm1\n\t"
+        "movdqu 32(%1), %%xmm2\n\t"
+        "movdqu 48(%1), %%xmm3\n\t"
+        "movntdq %%xmm0, (%0)\n\t"
+        "movntdq %%xmm1, 16(%0)\n\t"
+        "movntdq %%xmm2, 32(%0)\n\t"
+        "movntdq %%xmm3, 48(%0)\n\t"
+        "addl $64, %0\n\t"
+        "addl $64, %1\n\t"
+        "decl %2\n\t"
+        "jnz 1b\n\t"
+        "sfence"
+        : "+r"(dest), "+r"(src), "+r"(blocks)
+        :
+        : "memory");
+}
+
+static void memory_fill_nt_sse2(void *dest, uint32_t pattern, size_t blocks)
+{
+    __asm__ __volatile__(
+        "movd %2, %%xmm0\n\t"
+        "pshufd $0, %%xmm0, %%xmm0\n\t"
+        "1:\n\t"
+        "movntdq %%xmm0, (%0)\n\t"
+        "movntdq %%xmm0, 16(%0)\n\t"
+        "movntdq %%xmm0, 32(%0)\n\t"
+        "movntdq %%xmm0, 48(%0)\n\t"
+        "addl $64, %0\n\t"
+        "decl %1\n\t"
+        "jnz 1b\n\t"
+        "sfence"
+        : "+r"(dest), "+r"(blocks)
+        : "r"(pattern)
+        : "memory");
+}
+
+void *memcpy_stream(void *dest, const void *src, size_t len)
+{
+    if (!memory_use_sse2 || len < MEMORY_STREAM_THRESHOLD)
     {
-        *d++ = *s++;
+        return memcpy(dest, (void *)src, len);
     }
+
+    uint8_t *d = dest;
+    const uint8_t *s = src;
+
+    size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+    memcpy(d, (void *)s, head);
+    d += head;
+    s += head;
+    len -= head;
+
+    size_t blocks = len / 64;
+    fpu_kernel_begin();
+    memory_copy_nt_sse2(d, s, blocks);
+    fpu_kernel_end();
+
+    d += blocks * 64;
+    s += blocks * 64;
+    memcpy(d, (void *)s, len % 64);
     return dest;
-}
\ No newline at end of file
+}
+
+void *memset16_stream(void *ptr, uint16_t value, size_t count)
+{
+    // Odd addresses can never reach 16 byte alignment in whole pixels
+    if (!memory_use_sse2 || count * 2 < MEMORY_STREAM_THRESHOLD || ((uintptr_t)ptr & 1))
+    {
+        return memset16(ptr, value, count);
+    }
+
+    uint16_t *d = ptr;
+    size_t head = ((16 - ((uintptr_t)d & 15)) & 15) / 2;
+    memset16(d, value, head);
+    d += head;
+    count -= head;
+
+    size_t blocks = count / 32;
+    fpu_kernel_begin();
+    memory_fill_nt_sse2(d, ((uint32_t)value << 16) | value, blocks);
+    fpu_kernel_end();
+
+    d += blocks * 32;
+    memset16(d, value, count % 32);
+    return ptr;
+}
@@ -2,9 +2,30 @@
 #define MEMORY_H
 
 #include <stddef.h>
+#include <stdint.h>
+
+// Below this many bytes the streaming kernels just use the plain ones
+#define MEMORY_STREAM_THRESHOLD 256
 
 void *memset(void *ptr, int c, size_t size);
 int memcmp(void *s1, void *s2, int count);
 void *memcpy(void *dest, void *src, int len);
 
-#endif
\ No newline at end of file
+// Fills count 16-bit values, used for RGB565 pixels
+void *memset16(void *ptr, uint16_t value, size_t count);
+
+/**
+ * Picks the bulk kernels for this CPU, call after fpu_init. Until then, and on CPUs
+ * without SSE2, the streaming variants fall back to rep movs/stos.
+ */
+void memory_init();
+
+/**
+ * Copies and fills for large destinations that aren't read back soon, like the framebuffer.
+ * With SSE2 they use non-temporal stores that bypass the cache. Not for interrupt context,
+ * they take the FPU through fpu_kernel_begin.
+ */
+void *memcpy_stream(void *dest, const void *src, size_t len);
+void *memset16_stream(void *ptr, uint16_t value, size_t count);
+
+#endif
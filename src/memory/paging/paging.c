@@ -1,9 +1,30 @@
 #include "paging.h"
 #include "memory/heap/kheap.h"
 #include "status.h"
+#include "cpu/cpu.h"
 void paging_load_directory(uint32_t *directory);
 
 static uint32_t *current_directory = 0;
+
+struct paging_wc_range
+{
+    uint32_t start;
+    uint32_t end;
+};
+
+static bool paging_pat_enabled = false;
+static struct paging_wc_range paging_wc_ranges[PAGING_MAX_WC_RANGES];
+static int paging_wc_range_count = 0;
+
+static void paging_apply_write_combining(uint32_t *directory, struct paging_wc_range *range)
+{
+    for (uint32_t address = range->start; address < range->end; address += PAGING_PAGE_SIZE)
+    {
+        uint32_t entry = paging_get(directory, (void *)address);
+        entry &= ~PAGING_CACHE_DISABLED;
+        paging_set(directory, (void *)address, entry | PAGING_WRITE_COMBINING);
+    }
+}
 struct paging_4gb_chunk *paging_new_4gb(uint8_t flags)
 {
     uint32_t *directory = kzalloc(sizeof(uint32_t) * PAGING_TOTAL_ENTRIES_PER_TABLE);
@@ -19,6 +40,11 @@ struct paging_4gb_chunk *paging_new_4gb(uint8_t flags)
         directory[i] = (uint32_t)entry | flags | PAGING_IS_WRITEABLE;
     }
 
+    for (int i = 0; i < paging_wc_range_count; i++)
+    {
+        paging_apply_write_combining(directory, &paging_wc_ranges[i]);
+    }
+
     struct paging_4gb_chunk *chunk_4gb = kzalloc(sizeof(struct paging_4gb_chunk));
     chunk_4gb->directory_entry = directory;
     return chunk_4gb;
@@ -30,6 +56,69 @@ void paging_switch(struct paging_4gb_chunk *directory)
     current_directory = directory->directory_entry;
 }
 
+void paging_init_pat()
+{
+    const struct cpu_features *features = cpu_get_features();
+    if (!features->pat || !features->msr)
+    {
+        return;
+    }
+
+    // Flush caches around the change so no line is left cached under the old type
+    uint32_t flags = cpu_irq_save();
+    __asm__ __volatile__("wbinvd" : : : "memory");
+    cpu_write_msr(PAGING_PAT_MSR, PAGING_PAT_VALUE);
+    __asm__ __volatile__("wbinvd" : : : "memory");
+    if (current_directory)
+    {
+        paging_load_directory(current_directory);
+    }
+    cpu_irq_restore(flags);
+
+    paging_pat_enabled = true;
+}
+
+int paging_set_write_combining(void *start, uint32_t size)
+{
+    if (!paging_pat_enabled)
+    {
+        return 0;
+    }
+
+    if (size == 0 || paging_wc_range_count >= PAGING_MAX_WC_RANGES)
+    {
+        return -EINVARG;
+    }
+
+    struct paging_wc_range *range = &paging_wc_ranges[paging_wc_range_count++];
+    range->start = (uint32_t)paging_align_to_lower_page(start);
+    range->end = (uint32_t)paging_align_address((void *)((uint32_t)start + size));
+    if (range->end <= range->start)
+    {
+        // Range runs into the last page, stop short of it so the walk can't wrap
+        range->end = 0xFFFFF000;
+    }
+
+    if (current_directory)
+    {
+        paging_apply_write_combining(current_directory, range);
+        paging_load_directory(current_directory);
+    }
+
+    return 0;
+}
+
+uint32_t *paging_current_directory()
+{
+    return current_directory;
+}
+
+void paging_restore_directory(uint32_t *directory)
+{
+    paging_load_directory(directory);
+    current_directory = directory;
+}
+
 void paging_free_4gb(struct paging_4gb_chunk *chunk)
 {
     for (int i = 0; i < 1024; i++)
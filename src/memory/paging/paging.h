@@ -12,6 +12,12 @@
 #define PAGING_IS_PRESENT 0b00000001
 
 #define PAGING_TOTAL_ENTRIES_PER_TABLE 1024
+
+// PAT entry 1 (PWT set, PCD clear) is reprogrammed from write-through to write-combining
+#define PAGING_PAT_MSR 0x277
+#define PAGING_PAT_VALUE 0x0007040600070106ULL
+#define PAGING_WRITE_COMBINING PAGING_WRITE_THROUGH
+#define PAGING_MAX_WC_RANGES 4
 #define PAGING_PAGE_SIZE 4096
 
 struct paging_4gb_chunk
@@ -21,6 +27,18 @@ struct paging_4gb_chunk
 
 struct paging_4gb_chunk *paging_new_4gb(uint8_t flags);
 void paging_switch(struct paging_4gb_chunk* directory);
+
+// Programs the PAT MSR when the CPU has one, call once paging is enabled
+void paging_init_pat();
+
+/**
+ * Maps a physical range write-combining in the current directory and in every directory
+ * created afterwards. Meant for the framebuffer, does nothing without PAT support.
+ */
+int paging_set_write_combining(void *start, uint32_t size);
+// Used by interrupts that land in kernel code to put back whatever directory was live
+uint32_t *paging_current_directory();
+void paging_restore_directory(uint32_t *directory);
 void enable_paging();
 
 int paging_set(uint32_t *directory, void *virt, uint32_t val);
@@ -0,0 +1,262 @@
+#include "shm.h"
+#include "config.h"
+#include "status.h"
+#include "task/process.h"
+#include "task/task.h"
+#include "memory/memory.h"
+#include "memory/heap/kheap.h"
+#include "memory/paging/paging.h"
+#include "sync/spinlock.h"
+
+struct shm_region
+{
+    bool used;
+
+    // Physical frames, a page aligned kernel heap block
+    void *frames;
+    uint32_t pages;
+
+    // Number of process mappings, the region is freed when this drops to zero
+    int refcount;
+};
+
+static struct shm_region shm_regions[VIOS_MAX_SHM_REGIONS];
+
+// Covers the region table and every process' shm mappings
+static struct spinlock shm_lock;
+
+void shm_init()
+{
+    memset(shm_regions, 0, sizeof(shm_regions));
+    spinlock_init(&shm_lock, "shm");
+}
+
+static struct shm_region *shm_region_get(int region_id)
+{
+    // Region ids start at 1
+    if (region_id <= 0 || region_id > VIOS_MAX_SHM_REGIONS)
+    {
+        return 0;
+    }
+
+    struct shm_region *region = &shm_regions[region_id - 1];
+    return region->used ? region : 0;
+}
+
+static int shm_region_id(struct shm_region *region)
+{
+    return (int)(region - shm_regions) + 1;
+}
+
+static bool shm_range_free(struct process *process, uint32_t start, uint32_t size)
+{
+    for (int i = 0; i < VIOS_MAX_PROCESS_SHM_MAPPINGS; i++)
+    {
+        struct shm_mapping *mapping = &process->shm[i];
+        if (!mapping->region)
+        {
+            continue;
+        }
+
+        uint32_t other_start = (uint32_t)mapping->virt;
+        uint32_t other_end = other_start + mapping->region->pages * PAGING_PAGE_SIZE;
+        if (start < other_end && other_start < start + size)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Picks or validates the user address for a new mapping, returns 0 when nothing fits
+static uint32_t shm_choose_address(struct process *process, void *virt, uint32_t size)
+{
+    uint32_t start = (uint32_t)virt;
+    if (start)
+    {
+        if (!paging_is_aligned(virt) || start < VIOS_SHM_VIRTUAL_ADDRESS_START ||
+            start + size > VIOS_SHM_VIRTUAL_ADDRESS_END || !shm_range_free(process, start, size))
+        {
+            return 0;
+        }
+
+        return start;
+    }
+
+    // The window holds twice as many slots as a process can map, so a free one always exists
+    for (start = VIOS_SHM_VIRTUAL_ADDRESS_START; start < VIOS_SHM_VIRTUAL_ADDRESS_END; start += VIOS_SHM_MAX_SIZE)
+    {
+        if (shm_range_free(process, start, size))
+        {
+            return start;
+        }
+    }
+
+    return 0;
+}
+
+static int shm_map_locked(struct process *process, struct shm_region *region, void *virt, void **virt_out)
+{
+    struct shm_mapping *mapping = 0;
+    for (int i = 0; i < VIOS_MAX_PROCESS_SHM_MAPPINGS; i++)
+    {
+        if (!process->shm[i].region)
+        {
+            mapping = &process->shm[i];
+            break;
+        }
+    }
+
+    if (!mapping)
+    {
+        return -EISTKN;
+    }
+
+    uint32_t start = shm_choose_address(process, virt, region->pages * PAGING_PAGE_SIZE);
+    if (!start)
+    {
+        return -EINVARG;
+    }
+
+    int res = paging_map_range(process->task->page_directory, (void *)start, region->frames, region->pages,
+                               PAGING_IS_WRITEABLE | PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL);
+    if (res < 0)
+    {
+        paging_map_range(process->task->page_directory, (void *)start, (void *)start, region->pages, 0x00);
+        return res;
+    }
+
+    mapping->region = region;
+    mapping->virt = (void *)start;
+    region->refcount++;
+    *virt_out = (void *)start;
+    return 0;
+}
+
+static void shm_unmap_locked(struct process *process, struct shm_mapping *mapping)
+{
+    struct shm_region *region = mapping->region;
+    if (process->task)
+    {
+        paging_map_range(process->task->page_directory, mapping->virt, mapping->virt, region->pages, 0x00);
+    }
+
+    mapping->region = 0;
+    mapping->virt = 0;
+
+    region->refcount--;
+    if (region->refcount == 0)
+    {
+        kfree(region->frames);
+        memset(region, 0, sizeof(struct shm_region));
+    }
+}
+
+int shm_create(struct process *process, uint32_t size, void *virt, void **virt_out)
+{
+    if (size == 0 || size > VIOS_SHM_MAX_SIZE)
+    {
+        return -EINVARG;
+    }
+
+    uint32_t pages = (size + PAGING_PAGE_SIZE - 1) / PAGING_PAGE_SIZE;
+
+    // Heap blocks are page sized and page aligned, so the frames can be mapped as they are
+    void *frames = kzalloc(pages * PAGING_PAGE_SIZE);
+    if (!frames)
+    {
+        return -ENOMEM;
+    }
+
+    int res = -EISTKN;
+    uint32_t flags = spin_lock_irqsave(&shm_lock);
+    for (int i = 0; i < VIOS_MAX_SHM_REGIONS; i++)
+    {
+        struct shm_region *region = &shm_regions[i];
+        if (region->used)
+        {
+            continue;
+        }
+
+        region->used = true;
+        region->frames = frames;
+        region->pages = pages;
+        region->refcount = 0;
+
+        res = shm_map_locked(process, region, virt, virt_out);
+        if (res < 0)
+        {
+            memset(region, 0, sizeof(struct shm_region));
+            break;
+        }
+
+        res = shm_region_id(region);
+        break;
+    }
+    spin_unlock_irqrestore(&shm_lock, flags);
+
+    if (res < 0)
+    {
+        kfree(frames);
+    }
+
+    return res;
+}
+
+int shm_map(struct process *process, int region_id, void *virt, void **virt_out)
+{
+    uint32_t flags = spin_lock_irqsave(&shm_lock);
+    struct shm_region *region = shm_region_get(region_id);
+    int res = region ? shm_map_locked(process, region, virt, virt_out) : -EINVARG;
+    spin_unlock_irqrestore(&shm_lock, flags);
+    return res;
+}
+
+int shm_unmap(struct process *process, void *virt)
+{
+    int res = -EINVARG;
+    uint32_t flags = spin_lock_irqsave(&shm_lock);
+    for (int i = 0; i < VIOS_MAX_PROCESS_SHM_MAPPINGS; i++)
+    {
+        struct shm_mapping *mapping = &process->shm[i];
+        if (mapping->region && mapping->virt == virt)
+        {
+            shm_unmap_locked(process, mapping);
+            res = 0;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&shm_lock, flags);
+    return res;
+}
+
+void *shm_kernel_address(struct process *process, void *virt, uint32_t size)
+{
+    void *frames = 0;
+    uint32_t flags = spin_lock_irqsave(&shm_lock);
+    for (int i = 0; i < VIOS_MAX_PROCESS_SHM_MAPPINGS; i++)
+    {
+        struct shm_mapping *mapping = &process->shm[i];
+        if (mapping->region && mapping->virt == virt && size <= mapping->region->pages * PAGING_PAGE_SIZE)
+        {
+            frames = mapping->region->frames;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&shm_lock, flags);
+    return frames;
+}
+
+void shm_process_exit(struct process *process)
+{
+    uint32_t flags = spin_lock_irqsave(&shm_lock);
+    for (int i = 0; i < VIOS_MAX_PROCESS_SHM_MAPPINGS; i++)
+    {
+        if (process->shm[i].region)
+        {
+            shm_unmap_locked(process, &process->shm[i]);
+        }
+    }
+    spin_unlock_irqrestore(&shm_lock, flags);
+}
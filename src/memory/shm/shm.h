@@ -0,0 +1,39 @@
+#ifndef SHM_H
+#define SHM_H
+
+#include <stdint.h>
+
+struct process;
+struct shm_region;
+
+// One region mapped into a process, see process->shm
+struct shm_mapping
+{
+    struct shm_region *region;
+    void *virt;
+};
+
+void shm_init();
+
+/**
+ * Creates a region of at least size bytes and maps it into the creator.
+ * virt is a page aligned address inside the shared memory window, or 0 to let the kernel pick.
+ * Returns the region id and stores the mapped address in virt_out.
+ */
+int shm_create(struct process *process, uint32_t size, void *virt, void **virt_out);
+
+// Maps an existing region, the same physical frames end up in every process that maps it
+int shm_map(struct process *process, int region_id, void *virt, void **virt_out);
+
+// Drops the mapping at virt, the frames are freed with the last mapping of the region
+int shm_unmap(struct process *process, void *virt);
+
+/**
+ * Kernel address of the frames mapped at virt, so the kernel can read a region without
+ * switching directories. Returns 0 unless a mapping starts at virt and covers size bytes.
+ */
+void *shm_kernel_address(struct process *process, void *virt, uint32_t size);
+
+void shm_process_exit(struct process *process);
+
+#endif
@@ -1,9 +1,12 @@
 #include "mouse.h"
 #include "io/io.h"
 #include "idt/idt.h"
+#include "idt/softirq.h"
+#include "irq/irq.h"
 #include "task/task.h"
 #include "kernel.h"
 #include "graphics/graphics.h"
+#include "graphics/cursor.h"
 
 static struct mouse ps2_mouse;
 
@@ -18,6 +21,13 @@ void ps2_mouse_handle_packet(struct mouse *mouse);
 static uint8_t packet[3];
 static uint8_t packet_index = 0;
 
+// Complete packets assembled by the top half, decoded later by ps2_mouse_work
+#define PS2_MOUSE_PENDING_PACKETS 16
+static volatile uint8_t pending_packets[PS2_MOUSE_PENDING_PACKETS][3];
+static volatile uint32_t pending_head = 0;
+static volatile uint32_t pending_tail = 0;
+static struct softirq_work ps2_mouse_work;
+
 static int32_t mouse_x = 0;
 static int32_t mouse_y = 0;
 static int mouse_left = 0;
@@ -39,12 +49,26 @@ void ps2_mouse_handle_interrupt()
 
     packet_index = 0;
 
-    int dx = (int8_t)packet[1];
-    int dy = (int8_t)packet[2];
+    // Drop the packet rather than block when the deferred work falls behind
+    if (pending_tail - pending_head >= PS2_MOUSE_PENDING_PACKETS)
+        return;
+
+    volatile uint8_t *slot = pending_packets[pending_tail % PS2_MOUSE_PENDING_PACKETS];
+    slot[0] = packet[0];
+    slot[1] = packet[1];
+    slot[2] = packet[2];
+    pending_tail++;
+    softirq_raise(&ps2_mouse_work);
+}
+
+static void ps2_mouse_decode_packet(volatile uint8_t *bytes)
+{
+    int dx = (int8_t)bytes[1];
+    int dy = (int8_t)bytes[2];
 
-    if (packet[0] & 0x10)
+    if (bytes[0] & 0x10)
         dx |= 0xFFFFFF00;
-    if (packet[0] & 0x20)
+    if (bytes[0] & 0x20)
         dy |= 0xFFFFFF00;
 
     mouse_x += dx;
@@ -73,14 +97,34 @@ void ps2_mouse_handle_interrupt()
     if (mouse_y >= vbe->y_resolution)
         mouse_y = vbe->y_resolution - 1;
 
-    mouse_left = packet[0] & 0x01;
-    mouse_right = packet[0] & 0x02;
-    mouse_middle = packet[0] & 0x04;
+    mouse_left = bytes[0] & 0x01;
+    mouse_right = bytes[0] & 0x02;
+    mouse_middle = bytes[0] & 0x04;
 
     // Call handle_packet to update the struct
     ps2_mouse_handle_packet(&ps2_mouse);
 }
 
+// Deferred work, decodes every packet the top half queued since it last ran
+static void ps2_mouse_drain_packets(void *data)
+{
+    while (pending_head != pending_tail)
+    {
+        ps2_mouse_decode_packet(pending_packets[pending_head % PS2_MOUSE_PENDING_PACKETS]);
+        pending_head++;
+    }
+
+    // One overlay move for the whole burst, the scene itself isn't redrawn
+    cursor_move(ps2_mouse.x, ps2_mouse.y);
+}
+
+// Packet assembly only touches the statics above, decoding is left to ps2_mouse_work
+static int ps2_mouse_top_half(struct interrupt_frame *frame)
+{
+    ps2_mouse_handle_interrupt();
+    return IDT_IRQ_HANDLED;
+}
+
 int ps2_mouse_init_driver(struct mouse *mouse)
 {
     outb(PS2_COMMAND_PORT, 0xA8); // Enable auxiliary device
@@ -95,14 +139,10 @@ int ps2_mouse_init_driver(struct mouse *mouse)
     insb(PS2_DATA_PORT); // ACK
 
     // Register interrupt handler
-    // IRQ 12 maps to interrupt 0x2C after PIC remapping (0x28 + 4)
-    idt_register_interrupt_callback(0x2C, ps2_mouse_handle_interrupt);
-
-    // Enable IRQ 12 (mouse) on the slave PIC
-    // Read current mask, clear bit 4 (IRQ 12), write back
-    uint8_t mask = insb(0xA1);
-    mask &= ~(1 << 4); // Clear bit 4 for IRQ 12
-    outb(0xA1, mask);
+    softirq_work_init(&ps2_mouse_work, ps2_mouse_drain_packets, 0);
+    idt_register_fast_interrupt_callback(IRQ_VECTOR(IRQ_MOUSE), ps2_mouse_top_half);
+
+    irq_unmask(IRQ_MOUSE);
 
     return 0;
 }
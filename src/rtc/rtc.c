@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "io/io.h"
+#include "time/ktime.h"
 
 #define CMOS_ADDRESS 0x70
 #define CMOS_DATA 0x71
@@ -68,6 +69,12 @@ void sleep_seconds(int seconds)
     if (seconds <= 0)
         return;
 
+    if (ktime_tsc_available())
+    {
+        ktime_delay_ms((uint32_t)seconds * 1000);
+        return;
+    }
+
     struct rtc_time start, current;
     rtc_read(&start);
 
@@ -88,26 +95,10 @@ void sleep_seconds(int seconds)
     } while (total_current_seconds < total_target_seconds);
 }
 
-#define PIT_CHANNEL2_DATA 0x42
-#define PIT_COMMAND 0x43
-
 void sleep_ms(int ms)
 {
     if (ms <= 0)
         return;
 
-    // Calculate countdown value (approximate)
-    // PIT runs at 1,193,182 Hz, so counts = ms * 1193
-    int count = ms * 1193;
-
-    // Setup PIT channel 2 in mode 0 (one-shot)
-    outb(PIT_COMMAND, 0xB6);
-
-    // Load low byte then high byte
-    outb(PIT_CHANNEL2_DATA, count & 0xFF);
-    outb(PIT_CHANNEL2_DATA, (count >> 8) & 0xFF);
-
-    // Wait until counter reaches zero by polling bit 5 of port 0x61
-    while (inb(0x61) & 0x20)
-        ;
+    ktime_delay_ms((uint32_t)ms);
 }
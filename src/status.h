@@ -14,5 +14,6 @@
 #define ENOSPC 10
 #define ENODEV 11
 #define ETIMEOUT 12
+#define EAGAIN 13
 
 #endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "futex.h"
+#include "spinlock.h"
+#include "config.h"
+#include "status.h"
+#include "task/task.h"
+#include "task/sched.h"
+#include "memory/paging/paging.h"
+
+// Waiters are hashed on the physical address so tasks sharing memory meet on the same queue
+struct futex_bucket
+{
+    struct spinlock lock;
+    struct task *head;
+    struct task *tail;
+};
+
+static struct futex_bucket futex_buckets[VIOS_FUTEX_HASH_BUCKETS];
+
+void futex_init()
+{
+    for (int i = 0; i < VIOS_FUTEX_HASH_BUCKETS; i++)
+    {
+        // Buckets are too many to track individually, only the first one reports contention
+        spinlock_init(&futex_buckets[i].lock, i == 0 ? "futex_bucket0" : 0);
+        futex_buckets[i].head = 0;
+        futex_buckets[i].tail = 0;
+    }
+}
+
+static struct futex_bucket *futex_bucket_for(uint32_t key)
+{
+    uint32_t word = key >> 2;
+    return &futex_buckets[(word ^ (word >> 10)) & (VIOS_FUTEX_HASH_BUCKETS - 1)];
+}
+
+static int futex_resolve(struct task *task, void *uaddr, uint32_t *key_out)
+{
+    // Aligned words never straddle a page
+    if (!uaddr || ((uint32_t)uaddr & 0x03))
+    {
+        return -EINVARG;
+    }
+
+    uint32_t entry = paging_get(task->page_directory->directory_entry, paging_align_to_lower_page(uaddr));
+    if (!(entry & PAGING_IS_PRESENT) || !(entry & PAGING_ACCESS_FROM_ALL))
+    {
+        return -EINVARG;
+    }
+
+    *key_out = (entry & 0xfffff000) + ((uint32_t)uaddr & 0xfff);
+    return 0;
+}
+
+static void futex_bucket_unlink(struct futex_bucket *bucket, struct task *prev, struct task *task)
+{
+    if (prev)
+    {
+        prev->futex_next = task->futex_next;
+    }
+    else
+    {
+        bucket->head = task->futex_next;
+    }
+
+    if (bucket->tail == task)
+    {
+        bucket->tail = prev;
+    }
+
+    task->futex_next = 0;
+    task->futex_key = 0;
+}
+
+int futex_wait(struct task *task, void *uaddr, uint32_t expected)
+{
+    uint32_t key = 0;
+    int res = futex_resolve(task, uaddr, &key);
+    if (res < 0)
+    {
+        return res;
+    }
+
+    struct futex_bucket *bucket = futex_bucket_for(key);
+    uint32_t flags = spin_lock_irqsave(&bucket->lock);
+
+    // Checked under the bucket lock so a wake between the user's check and here isn't lost
+    if (*(volatile uint32_t *)key != expected)
+    {
+        res = -EAGAIN;
+        goto out;
+    }
+
+    task->futex_key = key;
+    task->futex_next = 0;
+    if (bucket->tail)
+    {
+        bucket->tail->futex_next = task;
+    }
+    else
+    {
+        bucket->head = task;
+    }
+    bucket->tail = task;
+    task->state = TASK_STATE_BLOCKED;
+
+out:
+    spin_unlock_irqrestore(&bucket->lock, flags);
+    return res;
+}
+
+int futex_wake(struct task *task, void *uaddr, int count)
+{
+    uint32_t key = 0;
+    int res = futex_resolve(task, uaddr, &key);
+    if (res < 0)
+    {
+        return res;
+    }
+
+    struct futex_bucket *bucket = futex_bucket_for(key);
+    struct task *woken = 0;
+    int total = 0;
+
+    uint32_t flags = spin_lock_irqsave(&bucket->lock);
+    struct task *prev = 0;
+    struct task *current = bucket->head;
+    while (current && total < count)
+    {
+        struct task *next = current->futex_next;
+        if (current->futex_key == key)
+        {
+            futex_bucket_unlink(bucket, prev, current);
+            current->futex_next = woken;
+            woken = current;
+            total++;
+        }
+        else
+        {
+            prev = current;
+        }
+        current = next;
+    }
+    spin_unlock_irqrestore(&bucket->lock, flags);
+
+    // Make them runnable outside the bucket lock, the wait syscall returns zero
+    while (woken)
+    {
+        struct task *next = woken->futex_next;
+        woken->futex_next = 0;
+        woken->registers.eax = 0;
+        sched_enqueue(woken);
+        woken = next;
+    }
+
+    return total;
+}
+
+void futex_task_free(struct task *task)
+{
+    if (!task->futex_key)
+    {
+        return;
+    }
+
+    struct futex_bucket *bucket = futex_bucket_for(task->futex_key);
+    uint32_t flags = spin_lock_irqsave(&bucket->lock);
+    struct task *prev = 0;
+    for (struct task *current = bucket->head; current; current = current->futex_next)
+    {
+        if (current == task)
+        {
+            futex_bucket_unlink(bucket, prev, current);
+            break;
+        }
+        prev = current;
+    }
+    spin_unlock_irqrestore(&bucket->lock, flags);
+}
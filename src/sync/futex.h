@@ -0,0 +1,21 @@
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include <stdint.h>
+
+struct task;
+
+void futex_init();
+
+/**
+ * Blocks the task on the user address if it still holds the expected value.
+ * Returns -EAGAIN if the value changed, on success the caller must schedule away with task_next().
+ */
+int futex_wait(struct task *task, void *uaddr, uint32_t expected);
+
+// Wakes up to count tasks waiting on the user address, returns how many were woken
+int futex_wake(struct task *task, void *uaddr, int count);
+
+void futex_task_free(struct task *task);
+
+#endif
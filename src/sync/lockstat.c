@@ -0,0 +1,63 @@
+#include "lockstat.h"
+#include "config.h"
+
+static struct lock_stats *lockstat_registry[VIOS_MAX_TRACKED_LOCKS];
+static volatile int lockstat_registered = 0;
+
+void lockstat_register(struct lock_stats *stats, const char *name)
+{
+    stats->name = name;
+    stats->acquisitions = 0;
+    stats->contentions = 0;
+    stats->spins = 0;
+
+    if (!name)
+    {
+        return;
+    }
+
+    int index = __atomic_fetch_add(&lockstat_registered, 1, __ATOMIC_RELAXED);
+    if (index >= VIOS_MAX_TRACKED_LOCKS)
+    {
+        // Still usable, just not reported
+        __atomic_fetch_sub(&lockstat_registered, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    lockstat_registry[index] = stats;
+}
+
+void lockstat_record(struct lock_stats *stats, uint32_t spins)
+{
+    __atomic_fetch_add(&stats->acquisitions, 1, __ATOMIC_RELAXED);
+    if (spins)
+    {
+        __atomic_fetch_add(&stats->contentions, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&stats->spins, spins, __ATOMIC_RELAXED);
+    }
+}
+
+int lockstat_count()
+{
+    return lockstat_registered;
+}
+
+const struct lock_stats *lockstat_get(int index)
+{
+    if (index < 0 || index >= lockstat_registered)
+    {
+        return 0;
+    }
+
+    return lockstat_registry[index];
+}
+
+void lockstat_reset()
+{
+    for (int i = 0; i < lockstat_registered; i++)
+    {
+        lockstat_registry[i]->acquisitions = 0;
+        lockstat_registry[i]->contentions = 0;
+        lockstat_registry[i]->spins = 0;
+    }
+}
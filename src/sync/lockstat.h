@@ -0,0 +1,25 @@
+#ifndef LOCKSTAT_H
+#define LOCKSTAT_H
+
+#include <stdint.h>
+
+struct lock_stats
+{
+    const char *name;
+
+    uint32_t acquisitions;
+
+    // Acquisitions that had to wait for another holder
+    uint32_t contentions;
+
+    // Total spin iterations spent waiting
+    uint32_t spins;
+};
+
+void lockstat_register(struct lock_stats *stats, const char *name);
+void lockstat_record(struct lock_stats *stats, uint32_t spins);
+int lockstat_count();
+const struct lock_stats *lockstat_get(int index);
+void lockstat_reset();
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef PERCPU_H
+#define PERCPU_H
+
+#include "config.h"
+#include "cpu/cpu.h"
+
+// Per-CPU variables are plain arrays indexed by CPU id, only the owning CPU touches its slot
+#define DEFINE_PER_CPU(type, name) type name[VIOS_MAX_CPUS]
+#define per_cpu(name, cpu) (name[(cpu)])
+#define this_cpu(name) (name[cpu_current_id()])
+
+#endif
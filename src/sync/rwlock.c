@@ -0,0 +1,65 @@
+#include "rwlock.h"
+#include <stdbool.h>
+
+static void rwlock_pause()
+{
+    __asm__ __volatile__("pause" : : : "memory");
+}
+
+void rwlock_init(struct rwlock *lock, const char *name)
+{
+    lock->state = 0;
+    lock->writers_waiting = 0;
+    lockstat_register(&lock->stats, name);
+}
+
+void read_lock(struct rwlock *lock)
+{
+    uint32_t spins = 0;
+    while (true)
+    {
+        uint32_t state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+        if (!(state & RWLOCK_WRITER) && __atomic_load_n(&lock->writers_waiting, __ATOMIC_RELAXED) == 0)
+        {
+            if (__atomic_compare_exchange_n(&lock->state, &state, state + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+
+        rwlock_pause();
+        spins++;
+    }
+
+    lockstat_record(&lock->stats, spins);
+}
+
+void read_unlock(struct rwlock *lock)
+{
+    __atomic_fetch_sub(&lock->state, 1, __ATOMIC_RELEASE);
+}
+
+void write_lock(struct rwlock *lock)
+{
+    uint32_t spins = 0;
+    __atomic_fetch_add(&lock->writers_waiting, 1, __ATOMIC_RELAXED);
+    while (true)
+    {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&lock->state, &expected, RWLOCK_WRITER, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+
+        rwlock_pause();
+        spins++;
+    }
+    __atomic_fetch_sub(&lock->writers_waiting, 1, __ATOMIC_RELAXED);
+
+    lockstat_record(&lock->stats, spins);
+}
+
+void write_unlock(struct rwlock *lock)
+{
+    __atomic_store_n(&lock->state, 0, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,26 @@
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include <stdint.h>
+#include "lockstat.h"
+
+#define RWLOCK_WRITER 0x80000000
+
+/**
+ * Reader-writer spinlock. The low bits count readers, RWLOCK_WRITER marks an active writer.
+ * A waiting writer blocks new readers so it cannot be starved.
+ */
+struct rwlock
+{
+    volatile uint32_t state;
+    volatile uint32_t writers_waiting;
+    struct lock_stats stats;
+};
+
+void rwlock_init(struct rwlock *lock, const char *name);
+void read_lock(struct rwlock *lock);
+void read_unlock(struct rwlock *lock);
+void write_lock(struct rwlock *lock);
+void write_unlock(struct rwlock *lock);
+
+#endif
@@ -0,0 +1,65 @@
+#include "spinlock.h"
+#include "cpu/cpu.h"
+
+static void spin_pause()
+{
+    __asm__ __volatile__("pause" : : : "memory");
+}
+
+void spinlock_init(struct spinlock *lock, const char *name)
+{
+    lock->next = 0;
+    lock->owner = 0;
+    lockstat_register(&lock->stats, name);
+}
+
+void spin_lock(struct spinlock *lock)
+{
+    uint16_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+    uint32_t spins = 0;
+    while (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket)
+    {
+        spin_pause();
+        spins++;
+    }
+
+    lockstat_record(&lock->stats, spins);
+}
+
+bool spin_trylock(struct spinlock *lock)
+{
+    uint16_t owner = __atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE);
+    uint16_t expected = owner;
+
+    // Only take a ticket when it would be served immediately
+    if (!__atomic_compare_exchange_n(&lock->next, &expected, (uint16_t)(owner + 1), false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return false;
+    }
+
+    lockstat_record(&lock->stats, 0);
+    return true;
+}
+
+void spin_unlock(struct spinlock *lock)
+{
+    __atomic_store_n(&lock->owner, (uint16_t)(lock->owner + 1), __ATOMIC_RELEASE);
+}
+
+bool spin_is_locked(struct spinlock *lock)
+{
+    return __atomic_load_n(&lock->owner, __ATOMIC_RELAXED) != __atomic_load_n(&lock->next, __ATOMIC_RELAXED);
+}
+
+uint32_t spin_lock_irqsave(struct spinlock *lock)
+{
+    uint32_t flags = cpu_irq_save();
+    spin_lock(lock);
+    return flags;
+}
+
+void spin_unlock_irqrestore(struct spinlock *lock, uint32_t flags)
+{
+    spin_unlock(lock);
+    cpu_irq_restore(flags);
+}
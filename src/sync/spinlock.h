@@ -0,0 +1,28 @@
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lockstat.h"
+
+/**
+ * Ticket spinlock, waiters are served in FIFO order.
+ * Use the irqsave variants for anything that is also touched from an interrupt handler.
+ */
+struct spinlock
+{
+    volatile uint16_t next;
+    volatile uint16_t owner;
+    struct lock_stats stats;
+};
+
+void spinlock_init(struct spinlock *lock, const char *name);
+void spin_lock(struct spinlock *lock);
+bool spin_trylock(struct spinlock *lock);
+void spin_unlock(struct spinlock *lock);
+bool spin_is_locked(struct spinlock *lock);
+
+uint32_t spin_lock_irqsave(struct spinlock *lock);
+void spin_unlock_irqrestore(struct spinlock *lock, uint32_t flags);
+
+#endif
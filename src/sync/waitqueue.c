@@ -0,0 +1,86 @@
+#include "waitqueue.h"
+#include "task/task.h"
+#include "task/sched.h"
+
+void wait_queue_init(struct wait_queue *queue)
+{
+    spinlock_init(&queue->lock, 0);
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+void wait_queue_block(struct wait_queue *queue, struct task *task)
+{
+    uint32_t flags = spin_lock_irqsave(&queue->lock);
+    task->wait_next = 0;
+    task->wait_queue = queue;
+    if (queue->tail)
+    {
+        queue->tail->wait_next = task;
+    }
+    else
+    {
+        queue->head = task;
+    }
+    queue->tail = task;
+    task->state = TASK_STATE_BLOCKED;
+    spin_unlock_irqrestore(&queue->lock, flags);
+}
+
+int wait_queue_wake_all(struct wait_queue *queue)
+{
+    uint32_t flags = spin_lock_irqsave(&queue->lock);
+    struct task *task = queue->head;
+    queue->head = 0;
+    queue->tail = 0;
+    spin_unlock_irqrestore(&queue->lock, flags);
+
+    int total = 0;
+    while (task)
+    {
+        struct task *next = task->wait_next;
+        task->wait_next = 0;
+        task->wait_queue = 0;
+        sched_enqueue(task);
+        task = next;
+        total++;
+    }
+
+    return total;
+}
+
+void wait_queue_remove(struct task *task)
+{
+    struct wait_queue *queue = task->wait_queue;
+    if (!queue)
+    {
+        return;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&queue->lock);
+    struct task *prev = 0;
+    for (struct task *current = queue->head; current; current = current->wait_next)
+    {
+        if (current == task)
+        {
+            if (prev)
+            {
+                prev->wait_next = current->wait_next;
+            }
+            else
+            {
+                queue->head = current->wait_next;
+            }
+
+            if (queue->tail == current)
+            {
+                queue->tail = prev;
+            }
+            break;
+        }
+        prev = current;
+    }
+    task->wait_next = 0;
+    task->wait_queue = 0;
+    spin_unlock_irqrestore(&queue->lock, flags);
+}
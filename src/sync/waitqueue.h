@@ -0,0 +1,27 @@
+#ifndef WAITQUEUE_H
+#define WAITQUEUE_H
+
+#include "spinlock.h"
+
+struct task;
+
+// FIFO of blocked tasks, linked through task->wait_next
+struct wait_queue
+{
+    struct spinlock lock;
+    struct task *head;
+    struct task *tail;
+};
+
+void wait_queue_init(struct wait_queue *queue);
+
+// Marks the task blocked and queues it, the caller then schedules away with task_next()
+void wait_queue_block(struct wait_queue *queue, struct task *task);
+
+// Makes every queued task runnable again, returns how many were woken
+int wait_queue_wake_all(struct wait_queue *queue);
+
+// Drops the task from whatever queue it is blocked on, used when a task is freed
+void wait_queue_remove(struct task *task);
+
+#endif
@@ -0,0 +1,179 @@
+#include "fpu.h"
+#include "task.h"
+#include "cpu/cpu.h"
+#include "idt/idt.h"
+#include "config.h"
+#include "sync/percpu.h"
+
+// The task whose FPU/SSE state is currently loaded in the registers of each CPU
+static DEFINE_PER_CPU(struct task *, fpu_owner);
+
+// Freshly initialized state handed to a task on its first FPU instruction
+static struct fpu_state fpu_initial_state;
+
+static bool fpu_enabled = false;
+static bool fpu_use_fxsr = false;
+
+static void fpu_clts()
+{
+    __asm__ __volatile__("clts");
+}
+
+static void fpu_stts()
+{
+    cpu_write_cr0(cpu_read_cr0() | CPU_CR0_TS);
+}
+
+static void fpu_save(struct fpu_state *state)
+{
+    if (fpu_use_fxsr)
+    {
+        __asm__ __volatile__("fxsave %0" : "=m"(*state));
+    }
+    else
+    {
+        __asm__ __volatile__("fnsave %0; fwait" : "=m"(*state));
+    }
+}
+
+static void fpu_restore(struct fpu_state *state)
+{
+    if (fpu_use_fxsr)
+    {
+        __asm__ __volatile__("fxrstor %0" : : "m"(*state));
+    }
+    else
+    {
+        __asm__ __volatile__("frstor %0" : : "m"(*state));
+    }
+}
+
+/**
+ * #NM handler, raised by the first FPU/SSE instruction after a task switch.
+ * Only now is the previous owner's state saved and the current task's state loaded.
+ */
+static void fpu_handle_device_not_available(struct interrupt_frame *frame)
+{
+    fpu_clts();
+
+    struct task *task = task_current();
+    struct task *owner = this_cpu(fpu_owner);
+    if (owner == task)
+    {
+        return;
+    }
+
+    if (owner)
+    {
+        fpu_save(&owner->fpu);
+    }
+
+    if (task)
+    {
+        fpu_restore(task->fpu_used ? &task->fpu : &fpu_initial_state);
+        task->fpu_used = true;
+    }
+
+    this_cpu(fpu_owner) = task;
+}
+
+void fpu_init()
+{
+    const struct cpu_features *features = cpu_get_features();
+    if (!features->fpu)
+    {
+        return;
+    }
+
+    uint32_t cr0 = cpu_read_cr0();
+    cr0 &= ~(CPU_CR0_EM | CPU_CR0_TS);
+    cr0 |= CPU_CR0_MP | CPU_CR0_NE;
+    cpu_write_cr0(cr0);
+
+    if (features->fxsr)
+    {
+        uint32_t cr4 = cpu_read_cr4() | CPU_CR4_OSFXSR;
+        if (features->sse)
+        {
+            cr4 |= CPU_CR4_OSXMMEXCPT;
+        }
+        cpu_write_cr4(cr4);
+        fpu_use_fxsr = true;
+    }
+
+    __asm__ __volatile__("fninit");
+    if (features->sse)
+    {
+        uint32_t mxcsr = 0x1F80; // All SSE exceptions masked
+        __asm__ __volatile__("ldmxcsr %0" : : "m"(mxcsr));
+    }
+
+    fpu_save(&fpu_initial_state);
+    if (!fpu_use_fxsr)
+    {
+        // FNSAVE reinitializes the FPU, reload so the kernel keeps a usable state
+        fpu_restore(&fpu_initial_state);
+    }
+
+    idt_register_interrupt_callback(FPU_DEVICE_NOT_AVAILABLE_INTERRUPT, fpu_handle_device_not_available);
+    fpu_enabled = true;
+}
+
+void fpu_task_switched(struct task *next)
+{
+    if (!fpu_enabled)
+    {
+        return;
+    }
+
+    // Leave the FPU usable if the incoming task's state is still in the registers
+    if (this_cpu(fpu_owner) == next)
+    {
+        fpu_clts();
+        return;
+    }
+
+    fpu_stts();
+}
+
+void fpu_task_free(struct task *task)
+{
+    for (int i = 0; i < VIOS_MAX_CPUS; i++)
+    {
+        if (per_cpu(fpu_owner, i) == task)
+        {
+            per_cpu(fpu_owner, i) = 0;
+        }
+    }
+}
+
+void fpu_kernel_begin()
+{
+    if (!fpu_enabled)
+    {
+        return;
+    }
+
+    fpu_clts();
+
+    struct task *owner = this_cpu(fpu_owner);
+    if (owner)
+    {
+        fpu_save(&owner->fpu);
+        this_cpu(fpu_owner) = 0;
+    }
+}
+
+void fpu_kernel_end()
+{
+    if (!fpu_enabled)
+    {
+        return;
+    }
+
+    // The registers now hold kernel state, make the next task FPU use reload its own
+    if (task_current())
+    {
+        fpu_stts();
+    }
+}
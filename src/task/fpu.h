@@ -0,0 +1,25 @@
+#ifndef FPU_H
+#define FPU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FPU_DEVICE_NOT_AVAILABLE_INTERRUPT 0x07
+
+// FXSAVE image, FNSAVE only uses the first 108 bytes on CPUs without FXSR
+struct fpu_state
+{
+    uint8_t data[512];
+} __attribute__((aligned(16)));
+
+struct task;
+
+void fpu_init();
+void fpu_task_switched(struct task *next);
+void fpu_task_free(struct task *task);
+
+// Bracket kernel code that uses x87/SSE registers so user state isn't clobbered
+void fpu_kernel_begin();
+void fpu_kernel_end();
+
+#endif
@@ -0,0 +1,336 @@
+#include "ipc.h"
+#include "process.h"
+#include "task.h"
+#include "sched.h"
+#include "config.h"
+#include "status.h"
+#include "sync/spinlock.h"
+#include "memory/memory.h"
+
+struct ipc_port
+{
+    bool used;
+    struct process *owner;
+
+    // The owner when it is blocked in ipc_receive on this port
+    struct process *receiver;
+
+    // Senders waiting for the owner to receive, FIFO
+    struct process *senders_head;
+    struct process *senders_tail;
+};
+
+static struct ipc_port ipc_ports[VIOS_MAX_IPC_PORTS];
+
+// One lock covers the port table and every process' ipc endpoint
+static struct spinlock ipc_lock;
+
+void ipc_init()
+{
+    memset(ipc_ports, 0, sizeof(ipc_ports));
+    spinlock_init(&ipc_lock, "ipc");
+}
+
+static struct ipc_port *ipc_port_get(int port_id)
+{
+    // Port ids start at 1
+    if (port_id <= 0 || port_id > VIOS_MAX_IPC_PORTS)
+    {
+        return 0;
+    }
+
+    struct ipc_port *port = &ipc_ports[port_id - 1];
+    return port->used ? port : 0;
+}
+
+static void ipc_endpoint_reset(struct ipc_endpoint *endpoint)
+{
+    endpoint->state = IPC_STATE_IDLE;
+    endpoint->port = 0;
+    endpoint->server = 0;
+    endpoint->next = 0;
+}
+
+static void ipc_set_message_registers(struct registers *registers, uint32_t eax, struct ipc_message *message)
+{
+    registers->eax = eax;
+    registers->ecx = message->words[0];
+    registers->edx = message->words[1];
+    registers->edi = message->words[2];
+    registers->esi = (uint32_t)message->payload;
+}
+
+// Moves the payload pages from one page directory to the other, no data is copied
+static int ipc_transfer_payload(struct process *from, struct process *to, struct ipc_message *message)
+{
+    if (!message->payload)
+    {
+        return 0;
+    }
+
+    return process_allocation_transfer(from, to, message->payload);
+}
+
+// Makes a blocked process runnable again with status in EAX and optionally a message
+static void ipc_wake(struct process *process, int status, struct ipc_message *message)
+{
+    ipc_endpoint_reset(&process->ipc);
+    if (message)
+    {
+        ipc_set_message_registers(&process->task->registers, (uint32_t)status, message);
+    }
+    else
+    {
+        process->task->registers.eax = (uint32_t)status;
+    }
+
+    sched_enqueue(process->task);
+}
+
+static void ipc_port_remove_sender(struct ipc_port *port, struct process *sender)
+{
+    struct process *prev = 0;
+    for (struct process *current = port->senders_head; current; current = current->ipc.next)
+    {
+        if (current == sender)
+        {
+            if (prev)
+            {
+                prev->ipc.next = current->ipc.next;
+            }
+            else
+            {
+                port->senders_head = current->ipc.next;
+            }
+
+            if (port->senders_tail == current)
+            {
+                port->senders_tail = prev;
+            }
+
+            current->ipc.next = 0;
+            return;
+        }
+        prev = current;
+    }
+}
+
+static void ipc_port_release(struct ipc_port *port)
+{
+    // Nobody will ever receive these messages, fail the senders
+    while (port->senders_head)
+    {
+        struct process *sender = port->senders_head;
+        port->senders_head = sender->ipc.next;
+        ipc_wake(sender, -EIO, 0);
+    }
+
+    memset(port, 0, sizeof(struct ipc_port));
+}
+
+int ipc_port_create(struct process *owner)
+{
+    int res = -ENOMEM;
+    uint32_t flags = spin_lock_irqsave(&ipc_lock);
+    for (int i = 0; i < VIOS_MAX_IPC_PORTS; i++)
+    {
+        if (!ipc_ports[i].used)
+        {
+            memset(&ipc_ports[i], 0, sizeof(struct ipc_port));
+            ipc_ports[i].used = true;
+            ipc_ports[i].owner = owner;
+            res = i + 1;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&ipc_lock, flags);
+    return res;
+}
+
+int ipc_port_destroy(struct process *owner, int port_id)
+{
+    int res = 0;
+    uint32_t flags = spin_lock_irqsave(&ipc_lock);
+    struct ipc_port *port = ipc_port_get(port_id);
+    if (!port || port->owner != owner)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    ipc_port_release(port);
+
+out:
+    spin_unlock_irqrestore(&ipc_lock, flags);
+    return res;
+}
+
+int ipc_send(struct process *sender, int port_id, struct ipc_message *message)
+{
+    if (message->payload && !process_owns_allocation(sender, message->payload))
+    {
+        return -EINVARG;
+    }
+
+    int res = 0;
+    uint32_t flags = spin_lock_irqsave(&ipc_lock);
+    struct ipc_port *port = ipc_port_get(port_id);
+
+    // Sending to ourselves would block forever
+    if (!port || port->owner == sender)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    sender->ipc.message = *message;
+    struct process *receiver = port->receiver;
+    if (receiver)
+    {
+        // The owner is already waiting, hand the message straight over
+        res = ipc_transfer_payload(sender, receiver, message);
+        if (res < 0)
+        {
+            goto out;
+        }
+
+        port->receiver = 0;
+        ipc_wake(receiver, sender->id, message);
+
+        sender->ipc.state = IPC_STATE_REPLY_WAIT;
+        sender->ipc.server = receiver;
+    }
+    else
+    {
+        sender->ipc.state = IPC_STATE_SEND_WAIT;
+        sender->ipc.port = port;
+        sender->ipc.next = 0;
+        if (port->senders_tail)
+        {
+            port->senders_tail->ipc.next = sender;
+        }
+        else
+        {
+            port->senders_head = sender;
+        }
+        port->senders_tail = sender;
+    }
+
+    sender->task->state = TASK_STATE_BLOCKED;
+    res = 1;
+
+out:
+    spin_unlock_irqrestore(&ipc_lock, flags);
+    return res;
+}
+
+int ipc_receive(struct process *receiver, int port_id, struct ipc_message *message_out, int *sender_id_out)
+{
+    int res = 0;
+    uint32_t flags = spin_lock_irqsave(&ipc_lock);
+    struct ipc_port *port = ipc_port_get(port_id);
+    if (!port || port->owner != receiver)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    while (port->senders_head)
+    {
+        struct process *sender = port->senders_head;
+        port->senders_head = sender->ipc.next;
+        if (!port->senders_head)
+        {
+            port->senders_tail = 0;
+        }
+        sender->ipc.next = 0;
+
+        res = ipc_transfer_payload(sender, receiver, &sender->ipc.message);
+        if (res < 0)
+        {
+            // Our allocation table is full, fail this sender and try the next
+            ipc_wake(sender, res, 0);
+            continue;
+        }
+
+        sender->ipc.state = IPC_STATE_REPLY_WAIT;
+        sender->ipc.port = 0;
+        sender->ipc.server = receiver;
+        *message_out = sender->ipc.message;
+        *sender_id_out = sender->id;
+        res = 0;
+        goto out;
+    }
+
+    port->receiver = receiver;
+    receiver->ipc.state = IPC_STATE_RECEIVE_WAIT;
+    receiver->ipc.port = port;
+    receiver->task->state = TASK_STATE_BLOCKED;
+    res = 1;
+
+out:
+    spin_unlock_irqrestore(&ipc_lock, flags);
+    return res;
+}
+
+int ipc_reply(struct process *server, int sender_id, struct ipc_message *message)
+{
+    if (message->payload && !process_owns_allocation(server, message->payload))
+    {
+        return -EINVARG;
+    }
+
+    int res = 0;
+    uint32_t flags = spin_lock_irqsave(&ipc_lock);
+    struct process *sender = process_get(sender_id);
+    if (!sender || sender->ipc.state != IPC_STATE_REPLY_WAIT || sender->ipc.server != server)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    res = ipc_transfer_payload(server, sender, message);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    ipc_wake(sender, 0, message);
+
+out:
+    spin_unlock_irqrestore(&ipc_lock, flags);
+    return res;
+}
+
+void ipc_process_exit(struct process *process)
+{
+    uint32_t flags = spin_lock_irqsave(&ipc_lock);
+    if (process->ipc.state == IPC_STATE_SEND_WAIT)
+    {
+        ipc_port_remove_sender(process->ipc.port, process);
+    }
+    else if (process->ipc.state == IPC_STATE_RECEIVE_WAIT)
+    {
+        process->ipc.port->receiver = 0;
+    }
+    ipc_endpoint_reset(&process->ipc);
+
+    // Clients waiting on a reply from us will never get one
+    for (int i = 0; i < VIOS_MAX_PROCESSES; i++)
+    {
+        struct process *client = process_get(i);
+        if (client && client != process && client->ipc.state == IPC_STATE_REPLY_WAIT && client->ipc.server == process)
+        {
+            ipc_wake(client, -EIO, 0);
+        }
+    }
+
+    for (int i = 0; i < VIOS_MAX_IPC_PORTS; i++)
+    {
+        if (ipc_ports[i].used && ipc_ports[i].owner == process)
+        {
+            ipc_port_release(&ipc_ports[i]);
+        }
+    }
+    spin_unlock_irqrestore(&ipc_lock, flags);
+}
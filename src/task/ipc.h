@@ -0,0 +1,55 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include <stdint.h>
+
+#define IPC_MESSAGE_WORDS 3
+
+#define IPC_STATE_IDLE 0
+// Queued on a port waiting for its owner to receive
+#define IPC_STATE_SEND_WAIT 1
+// Message delivered, waiting for the receiver to reply
+#define IPC_STATE_REPLY_WAIT 2
+// Waiting on one of our own ports for a sender
+#define IPC_STATE_RECEIVE_WAIT 3
+
+struct process;
+struct ipc_port;
+
+/**
+ * Small messages travel in registers (ECX, EDX, EDI).
+ * A payload must be the start of a process_malloc allocation, its pages are
+ * moved from the sender's page directory to the receiver's rather than copied.
+ */
+struct ipc_message
+{
+    uint32_t words[IPC_MESSAGE_WORDS];
+    void *payload;
+};
+
+struct ipc_endpoint
+{
+    int state;
+    struct ipc_port *port;
+
+    // The process we sent to and are waiting on for a reply
+    struct process *server;
+
+    struct ipc_message message;
+
+    // Next sender queued on the same port
+    struct process *next;
+};
+
+void ipc_init();
+int ipc_port_create(struct process *owner);
+int ipc_port_destroy(struct process *owner, int port_id);
+
+// These return 1 when the caller was blocked and must schedule away with task_next()
+int ipc_send(struct process *sender, int port_id, struct ipc_message *message);
+int ipc_receive(struct process *receiver, int port_id, struct ipc_message *message_out, int *sender_id_out);
+int ipc_reply(struct process *server, int sender_id, struct ipc_message *message);
+
+void ipc_process_exit(struct process *process);
+
+#endif
@@ -10,7 +10,13 @@
 #include "loader/formats/elfloader.h"
 #include "panic/panic.h"
 #include "kernel.h"
+#include "time/vclock.h"
+#include "ipc.h"
+#include "fs/pipe.h"
+#include "memory/shm/shm.h"
+#include "graphics/compositor.h"
 
+// The foreground process, it receives keyboard input and plays audio
 struct process *current_process = 0;
 
 int process_free_process(struct process *process);
@@ -20,6 +26,90 @@ static struct process *processes[VIOS_MAX_PROCESSES] = {};
 static void process_init(struct process *process)
 {
     memset(process, 0, sizeof(struct process));
+    process->fds[PROCESS_FD_STDIN].type = PROCESS_FD_CONSOLE;
+    process->fds[PROCESS_FD_STDOUT].type = PROCESS_FD_CONSOLE;
+    wait_queue_init(&process->exit_waiters);
+}
+
+struct process_fd *process_fd_get(struct process *process, int fd)
+{
+    if (fd < 0 || fd >= VIOS_MAX_PROCESS_FDS)
+    {
+        return NULL;
+    }
+
+    struct process_fd *entry = &process->fds[fd];
+    if (entry->type == PROCESS_FD_NONE)
+    {
+        return NULL;
+    }
+
+    return entry;
+}
+
+/**
+ * Installs a descriptor at fd, or at the first free slot from PROCESS_FD_FIRST_FREE when fd is negative.
+ * Takes a new reference on the pipe end, returns the descriptor used.
+ */
+int process_fd_install(struct process *process, int fd, int type, struct pipe *pipe)
+{
+    if (fd < 0)
+    {
+        for (int i = PROCESS_FD_FIRST_FREE; i < VIOS_MAX_PROCESS_FDS; i++)
+        {
+            if (process->fds[i].type == PROCESS_FD_NONE)
+            {
+                fd = i;
+                break;
+            }
+        }
+
+        if (fd < 0)
+        {
+            return -EISTKN;
+        }
+    }
+
+    if (fd >= VIOS_MAX_PROCESS_FDS)
+    {
+        return -EINVARG;
+    }
+
+    process_fd_close(process, fd);
+    if (type == PROCESS_FD_PIPE_READ)
+    {
+        pipe_open_reader(pipe);
+    }
+    else if (type == PROCESS_FD_PIPE_WRITE)
+    {
+        pipe_open_writer(pipe);
+    }
+
+    process->fds[fd].type = type;
+    process->fds[fd].pipe = pipe;
+    return fd;
+}
+
+int process_fd_close(struct process *process, int fd)
+{
+    struct process_fd *entry = process_fd_get(process, fd);
+    if (!entry)
+    {
+        return -EINVARG;
+    }
+
+    if (entry->type == PROCESS_FD_PIPE_READ)
+    {
+        pipe_close_reader(entry->pipe);
+    }
+    else if (entry->type == PROCESS_FD_PIPE_WRITE)
+    {
+        pipe_close_writer(entry->pipe);
+    }
+
+    entry->type = PROCESS_FD_NONE;
+    entry->pipe = NULL;
+    return 0;
 }
 
 struct process *process_current()
@@ -90,7 +180,7 @@ out_err:
     return 0;
 }
 
-static bool process_is_process_pointer(struct process *process, void *ptr)
+bool process_owns_allocation(struct process *process, void *ptr)
 {
     for (int i = 0; i < VIOS_MAX_PROGRAM_ALLOCATIONS; i++)
     {
@@ -113,7 +203,7 @@ static void process_allocation_unjoin(struct process *process, void *ptr)
     }
 }
 
-static struct process_allocation *process_get_allocation_by_addr(struct process *process, void *addr)
+struct process_allocation *process_get_allocation(struct process *process, void *addr)
 {
     for (int i = 0; i < VIOS_MAX_PROGRAM_ALLOCATIONS; i++)
     {
@@ -124,6 +214,47 @@ static struct process_allocation *process_get_allocation_by_addr(struct process
     return 0;
 }
 
+int process_allocation_transfer(struct process *from, struct process *to, void *ptr)
+{
+    struct process_allocation *allocation = process_get_allocation(from, ptr);
+    if (!ptr || !allocation)
+    {
+        return -EINVARG;
+    }
+
+    int index = process_find_free_allocation_index(to);
+    if (index < 0)
+    {
+        return -ENOMEM;
+    }
+
+    // Allocations are identity mapped, so the pages keep their address in the new owner
+    int total_pages = ((uint32_t)paging_align_address(ptr + allocation->size) - (uint32_t)ptr) / PAGING_PAGE_SIZE;
+    int res = paging_map_range(to->task->page_directory, ptr, ptr, total_pages, PAGING_IS_WRITEABLE | PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL);
+    if (res < 0)
+    {
+        return res;
+    }
+
+    res = paging_map_range(from->task->page_directory, ptr, ptr, total_pages, 0x00);
+    if (res < 0)
+    {
+        paging_map_range(to->task->page_directory, ptr, ptr, total_pages, 0x00);
+        return res;
+    }
+
+    if (from->ring.ring == ptr)
+    {
+        syscall_ring_release(from);
+    }
+
+    to->allocations[index].ptr = ptr;
+    to->allocations[index].size = allocation->size;
+    allocation->ptr = 0x00;
+    allocation->size = 0;
+    return 0;
+}
+
 int process_terminate_allocations(struct process *process)
 {
     for (int i = 0; i < VIOS_MAX_PROGRAM_ALLOCATIONS; i++)
@@ -188,19 +319,49 @@ void process_switch_to_any()
     panic("No processes to switch too\n");
 }
 
+// The first task in process_wait on the process, normally the shell that spawned it
+static struct process *process_first_waiter(struct process *process)
+{
+    struct process *waiter = 0;
+    uint32_t flags = spin_lock_irqsave(&process->exit_waiters.lock);
+    if (process->exit_waiters.head)
+    {
+        waiter = process->exit_waiters.head->process;
+    }
+    spin_unlock_irqrestore(&process->exit_waiters.lock, flags);
+    return waiter;
+}
+
 static void process_unlink(struct process *process)
 {
     processes[process->id] = 0x00;
 
     if (current_process == process)
     {
-        process_switch_to_any();
+        // Keyboard input goes back to whoever waited for the process to finish
+        struct process *waiter = process_first_waiter(process);
+        if (waiter)
+        {
+            process_switch(waiter);
+        }
+        else
+        {
+            process_switch_to_any();
+        }
     }
 }
 
 int process_free_process(struct process *process)
 {
     int res = 0;
+    ipc_process_exit(process);
+    shm_process_exit(process);
+    compositor_process_exit(process);
+    syscall_ring_release(process);
+    for (int i = 0; i < VIOS_MAX_PROCESS_FDS; i++)
+    {
+        process_fd_close(process, i);
+    }
     process_terminate_allocations(process);
     process_free_program_data(process);
 
@@ -216,6 +377,7 @@ int process_free_process(struct process *process)
         process->task = NULL;
     }
 
+    wait_queue_wake_all(&process->exit_waiters);
     kfree(process);
 
     return res;
@@ -289,7 +451,7 @@ out:
 
 void process_free(struct process *process, void *ptr)
 {
-    struct process_allocation *allocation = process_get_allocation_by_addr(process, ptr);
+    struct process_allocation *allocation = process_get_allocation(process, ptr);
     if (!allocation)
     {
         return;
@@ -301,6 +463,12 @@ void process_free(struct process *process, void *ptr)
         return;
     }
 
+    // Stop the kernel writing completions into memory the process gave up
+    if (process->ring.ring == ptr)
+    {
+        syscall_ring_release(process);
+    }
+
     process_allocation_unjoin(process, ptr);
     kfree(ptr);
 }
@@ -420,6 +588,8 @@ int process_map_memory(struct process *process)
     }
 
     paging_map_to(process->task->page_directory, (void *)VIOS_PROGRAM_VIRTUAL_STACK_ADDRESS_END, process->stack, paging_align_address(process->stack + VIOS_USER_PROGRAM_STACK_SIZE), PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL | PAGING_IS_WRITEABLE);
+
+    res = vclock_map(process->task->page_directory);
 out:
     return res;
 }
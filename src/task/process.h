@@ -4,13 +4,34 @@
 #include <stdbool.h>
 
 #include "task.h"
+#include "ipc.h"
 #include "config.h"
+#include "sync/waitqueue.h"
+#include "memory/shm/shm.h"
+#include "graphics/user_surface.h"
+#include "syscall_ring.h"
 
 #define PROCESS_FILETYPE_ELF 0
 #define PROCESS_FILETYPE_BINARY 1
 
 typedef unsigned char PROCESS_FILETYPE;
 
+#define PROCESS_FD_NONE 0
+#define PROCESS_FD_CONSOLE 1
+#define PROCESS_FD_PIPE_READ 2
+#define PROCESS_FD_PIPE_WRITE 3
+
+#define PROCESS_FD_STDIN 0
+#define PROCESS_FD_STDOUT 1
+#define PROCESS_FD_FIRST_FREE 3
+
+struct pipe;
+struct process_fd
+{
+    int type;
+    struct pipe *pipe;
+};
+
 struct process_allocation
 {
     void *ptr;
@@ -73,6 +94,24 @@ struct process
 
     // The arguments of the process.
     struct process_arguments arguments;
+
+    // Message passing state, see task/ipc.c
+    struct ipc_endpoint ipc;
+
+    // Per process descriptors, stdin and stdout start out on the console
+    struct process_fd fds[VIOS_MAX_PROCESS_FDS];
+
+    // Tasks waiting in process_wait for this process to exit
+    struct wait_queue exit_waiters;
+
+    // Shared memory regions mapped into this process, see memory/shm/shm.c
+    struct shm_mapping shm[VIOS_MAX_PROCESS_SHM_MAPPINGS];
+
+    // Drawing surface, one of the shm mappings above, see graphics/user_surface.c
+    struct user_surface surface;
+
+    // Asynchronous system call ring, see task/syscall_ring.c
+    struct syscall_ring_state ring;
 };
 
 int process_switch(struct process *process);
@@ -83,9 +122,16 @@ struct process *process_current();
 struct process *process_get(int process_id);
 void *process_malloc(struct process *process, size_t size);
 void process_free(struct process *process, void *ptr);
+bool process_owns_allocation(struct process *process, void *ptr);
+struct process_allocation *process_get_allocation(struct process *process, void *addr);
+int process_allocation_transfer(struct process *from, struct process *to, void *ptr);
 
 void process_get_arguments(struct process *process, int *argc, char ***argv);
 int process_inject_arguments(struct process *process, struct command_argument *root_argument);
 int process_terminate(struct process *process);
 
+struct process_fd *process_fd_get(struct process *process, int fd);
+int process_fd_install(struct process *process, int fd, int type, struct pipe *pipe);
+int process_fd_close(struct process *process, int fd);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "sched.h"
+#include "task.h"
+#include "cpu/cpu.h"
+#include "memory/memory.h"
+#include "panic/panic.h"
+#include "status.h"
+
+#define SCHED_RUNQUEUE_MASK (VIOS_SCHED_RUNQUEUE_SIZE - 1)
+
+// Upper bound on how often an idle CPU retries stealing after losing a race
+#define SCHED_MAX_STEAL_RETRIES 4
+
+enum
+{
+    SCHED_DEQUE_EMPTY,
+    SCHED_DEQUE_FOUND,
+    SCHED_DEQUE_ABORT
+};
+
+static struct sched_runqueue runqueues[VIOS_MAX_CPUS];
+
+void sched_init()
+{
+    memset(runqueues, 0, sizeof(runqueues));
+}
+
+static int sched_deque_length(struct sched_deque *deque)
+{
+    int32_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    int32_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    int32_t length = bottom - top;
+    return length > 0 ? length : 0;
+}
+
+// Only ever called by the CPU that owns the deque
+static int sched_deque_push(struct sched_deque *deque, struct task *task)
+{
+    int32_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int32_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    if (bottom - top >= VIOS_SCHED_RUNQUEUE_SIZE)
+    {
+        return -ENOMEM;
+    }
+
+    __atomic_store_n(&deque->buffer[bottom & SCHED_RUNQUEUE_MASK], task, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+// May be called by any CPU
+static int sched_deque_steal(struct sched_deque *deque, struct task **task_out)
+{
+    int32_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int32_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+    if (top >= bottom)
+    {
+        return SCHED_DEQUE_EMPTY;
+    }
+
+    struct task *task = __atomic_load_n(&deque->buffer[top & SCHED_RUNQUEUE_MASK], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    {
+        return SCHED_DEQUE_ABORT;
+    }
+
+    *task_out = task;
+    return SCHED_DEQUE_FOUND;
+}
+
+static bool sched_task_is_runnable(struct task *task)
+{
+    return task && task->state == TASK_STATE_READY;
+}
+
+// Discards entries at the front of the deque that would be skipped when picked anyway
+static void sched_deque_drop_stale(struct sched_deque *deque)
+{
+    while (true)
+    {
+        int32_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+        int32_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+        if (top >= bottom)
+        {
+            return;
+        }
+
+        struct task *task = __atomic_load_n(&deque->buffer[top & SCHED_RUNQUEUE_MASK], __ATOMIC_RELAXED);
+        if (sched_task_is_runnable(task))
+        {
+            return;
+        }
+
+        // Losing the race means someone else took it, just look at the new front
+        __atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    }
+}
+
+void sched_enqueue(struct task *task)
+{
+    int cpu = cpu_current_id();
+    struct sched_deque *deque = &runqueues[cpu].deque;
+    task->state = TASK_STATE_READY;
+    task->cpu = cpu;
+    if (sched_deque_push(deque, task) == 0)
+    {
+        return;
+    }
+
+    // The queue holds every task several times over, so being full means it is
+    // clogged with stale entries. A task that can't be queued would never run again.
+    sched_deque_drop_stale(deque);
+    if (sched_deque_push(deque, task) < 0)
+    {
+        panic("sched_enqueue: run queue overflow\n");
+    }
+}
+
+static int sched_find_busiest_cpu(int self)
+{
+    int busiest = -1;
+    int busiest_length = 0;
+    for (int i = 0; i < VIOS_MAX_CPUS; i++)
+    {
+        if (i == self || !cpu_is_online(i))
+        {
+            continue;
+        }
+
+        int length = sched_deque_length(&runqueues[i].deque);
+        if (length > busiest_length)
+        {
+            busiest = i;
+            busiest_length = length;
+        }
+    }
+
+    return busiest;
+}
+
+static struct task *sched_steal(int self)
+{
+    struct sched_runqueue *runqueue = &runqueues[self];
+    for (int retry = 0; retry < SCHED_MAX_STEAL_RETRIES; retry++)
+    {
+        int victim = sched_find_busiest_cpu(self);
+        if (victim < 0)
+        {
+            break;
+        }
+
+        struct task *task = 0;
+        runqueue->stats.steal_attempts++;
+        int res = sched_deque_steal(&runqueues[victim].deque, &task);
+        if (res == SCHED_DEQUE_ABORT)
+        {
+            runqueue->stats.steal_failures++;
+            continue;
+        }
+
+        if (res == SCHED_DEQUE_FOUND && sched_task_is_runnable(task))
+        {
+            runqueue->stats.migrations_in++;
+            __atomic_add_fetch(&runqueues[victim].stats.migrations_out, 1, __ATOMIC_RELAXED);
+            task->cpu = self;
+            return task;
+        }
+    }
+
+    return 0;
+}
+
+struct task *sched_pick_next()
+{
+    int cpu = cpu_current_id();
+    struct sched_runqueue *runqueue = &runqueues[cpu];
+    struct task *task = 0;
+
+    // Take the oldest entry, like a thief does, so a task that keeps being re-queued can't
+    // starve the ones behind it. Stale entries (running, blocked or removed tasks) are dropped.
+    int res;
+    while ((res = sched_deque_steal(&runqueue->deque, &task)) != SCHED_DEQUE_EMPTY)
+    {
+        if (res == SCHED_DEQUE_FOUND && sched_task_is_runnable(task))
+        {
+            runqueue->stats.dispatches++;
+            return task;
+        }
+    }
+
+    task = sched_steal(cpu);
+    if (task)
+    {
+        runqueue->stats.dispatches++;
+    }
+
+    return task;
+}
+
+void sched_remove(struct task *task)
+{
+    for (int cpu = 0; cpu < VIOS_MAX_CPUS; cpu++)
+    {
+        struct sched_deque *deque = &runqueues[cpu].deque;
+        int32_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+        int32_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+        for (int32_t i = top; i < bottom; i++)
+        {
+            struct task *expected = task;
+            __atomic_compare_exchange_n(&deque->buffer[i & SCHED_RUNQUEUE_MASK], &expected, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+int sched_runqueue_length(int cpu)
+{
+    if (cpu < 0 || cpu >= VIOS_MAX_CPUS)
+    {
+        return -EINVARG;
+    }
+
+    return sched_deque_length(&runqueues[cpu].deque);
+}
+
+void sched_get_stats(int cpu, struct sched_stats *stats)
+{
+    if (cpu < 0 || cpu >= VIOS_MAX_CPUS || !stats)
+    {
+        return;
+    }
+
+    *stats = runqueues[cpu].stats;
+}
@@ -0,0 +1,54 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+struct task;
+
+/**
+ * Chase-Lev work-stealing deque of runnable tasks.
+ *
+ * The owning CPU pushes at the bottom. It takes from the top just like the other CPUs
+ * stealing from it, so its own tasks run in the order they became ready.
+ * Entries may be NULL when a task was removed while it was still queued.
+ */
+struct sched_deque
+{
+    volatile int32_t top;
+    volatile int32_t bottom;
+    struct task *volatile buffer[VIOS_SCHED_RUNQUEUE_SIZE];
+};
+
+struct sched_stats
+{
+    // Tasks this CPU took from another CPU's run queue
+    uint32_t migrations_in;
+
+    // Tasks other CPUs took from this CPU's run queue
+    uint32_t migrations_out;
+
+    uint32_t steal_attempts;
+
+    // Steals that lost the race against the owner or another thief
+    uint32_t steal_failures;
+
+    uint32_t dispatches;
+};
+
+struct sched_runqueue
+{
+    struct sched_deque deque;
+    struct sched_stats stats;
+};
+
+void sched_init();
+// Marks the task ready and queues it on this CPU, never fails
+void sched_enqueue(struct task *task);
+struct task *sched_pick_next();
+void sched_remove(struct task *task);
+int sched_runqueue_length(int cpu);
+void sched_get_stats(int cpu, struct sched_stats *stats);
+
+#endif
@@ -0,0 +1,218 @@
+#include "syscall_ring.h"
+#include "process.h"
+#include "task.h"
+#include "sched.h"
+#include "status.h"
+#include "isr80h/isr80h.h"
+#include "memory/memory.h"
+#include "sync/spinlock.h"
+#include "time/ktime.h"
+
+// Covers the timeouts, the kernel owned ring indices and the waiter of every process
+static struct spinlock syscall_ring_lock;
+
+// Timeouts armed across every process
+static volatile int syscall_ring_armed = 0;
+
+void syscall_ring_init()
+{
+    spinlock_init(&syscall_ring_lock, "syscall_ring");
+}
+
+int syscall_ring_setup(struct process *process, void *ring)
+{
+    // The ring must be a whole allocation of the process so the kernel can reach it identity mapped
+    struct process_allocation *allocation = process_get_allocation(process, ring);
+    if (!allocation || allocation->size < sizeof(struct syscall_ring))
+    {
+        return -EINVARG;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&syscall_ring_lock);
+    struct syscall_ring_state *state = &process->ring;
+    if (state->ring)
+    {
+        spin_unlock_irqrestore(&syscall_ring_lock, flags);
+        return -EISTKN;
+    }
+
+    memset(state, 0, sizeof(struct syscall_ring_state));
+    state->ring = ring;
+    memset(ring, 0, sizeof(struct syscall_ring));
+    spin_unlock_irqrestore(&syscall_ring_lock, flags);
+    return 0;
+}
+
+void syscall_ring_release(struct process *process)
+{
+    uint32_t flags = spin_lock_irqsave(&syscall_ring_lock);
+    syscall_ring_armed -= process->ring.pending;
+    memset(&process->ring, 0, sizeof(struct syscall_ring_state));
+    spin_unlock_irqrestore(&syscall_ring_lock, flags);
+}
+
+static void syscall_ring_complete(struct syscall_ring *ring, uint32_t user_data, int32_t result)
+{
+    struct syscall_ring_cqe *cqe = &ring->cq[ring->cq_tail % VIOS_SYSCALL_RING_ENTRIES];
+    cqe->user_data = user_data;
+    cqe->result = result;
+
+    // The entry must be visible before the process sees the new tail
+    asm volatile("" ::: "memory");
+    ring->cq_tail++;
+}
+
+static int syscall_ring_arm_timeout(struct syscall_ring_state *state, struct syscall_ring_sqe *sqe)
+{
+    // Without a TSC ktime_ns() counts ticks, with the tick off as well the deadline never comes
+    if (!ktime_tick_enabled() && !ktime_tsc_available())
+    {
+        return -EUNIMP;
+    }
+
+    for (int i = 0; i < VIOS_SYSCALL_RING_ENTRIES; i++)
+    {
+        struct syscall_ring_timeout *timeout = &state->timeouts[i];
+        if (!timeout->used)
+        {
+            timeout->used = true;
+            timeout->deadline_ns = ktime_ns() + (uint64_t)sqe->args[0] * 1000000ULL;
+            timeout->user_data = sqe->user_data;
+            state->pending++;
+            syscall_ring_armed++;
+            return 0;
+        }
+    }
+
+    return -EISTKN;
+}
+
+// Completes every timeout of the process whose deadline has passed, called with the ring lock held
+static void syscall_ring_expire(struct syscall_ring_state *state, uint64_t now)
+{
+    for (int i = 0; i < VIOS_SYSCALL_RING_ENTRIES && state->pending > 0; i++)
+    {
+        struct syscall_ring_timeout *timeout = &state->timeouts[i];
+        if (timeout->used && timeout->deadline_ns <= now)
+        {
+            timeout->used = false;
+            state->pending--;
+            syscall_ring_armed--;
+            syscall_ring_complete(state->ring, timeout->user_data, 0);
+        }
+    }
+}
+
+int syscall_ring_enter(struct process *process, uint32_t to_submit, uint32_t min_complete, bool *blocked)
+{
+    struct syscall_ring_state *state = &process->ring;
+    struct syscall_ring *ring = state->ring;
+    struct task *task = process->task;
+    *blocked = false;
+    if (!ring)
+    {
+        return -EINVARG;
+    }
+
+    int submitted = 0;
+    while ((uint32_t)submitted < to_submit && ring->sq_head != ring->sq_tail)
+    {
+        // Leave the rest queued while the completion queue couldn't take the result
+        uint32_t flags = spin_lock_irqsave(&syscall_ring_lock);
+        bool full = ring->cq_tail - ring->cq_head + state->pending >= VIOS_SYSCALL_RING_ENTRIES;
+        spin_unlock_irqrestore(&syscall_ring_lock, flags);
+        if (full)
+        {
+            break;
+        }
+
+        struct syscall_ring_sqe sqe;
+        memcpy(&sqe, &ring->sq[ring->sq_head % VIOS_SYSCALL_RING_ENTRIES], sizeof(sqe));
+        ring->sq_head++;
+        submitted++;
+
+        if (sqe.command == SYSCALL_RING_OP_TIMEOUT)
+        {
+            flags = spin_lock_irqsave(&syscall_ring_lock);
+            int res = syscall_ring_arm_timeout(state, &sqe);
+            if (res < 0)
+            {
+                syscall_ring_complete(ring, sqe.user_data, res);
+            }
+            spin_unlock_irqrestore(&syscall_ring_lock, flags);
+            continue;
+        }
+
+        int32_t result = -EINVARG;
+        if (isr80h_command_queueable(sqe.command))
+        {
+            result = (int32_t)isr80h_dispatch_queued(task, sqe.command, sqe.args, SYSCALL_RING_MAX_ARGS);
+        }
+
+        flags = spin_lock_irqsave(&syscall_ring_lock);
+        syscall_ring_complete(ring, sqe.user_data, result);
+        spin_unlock_irqrestore(&syscall_ring_lock, flags);
+    }
+
+    // Only armed timeouts can still produce completions, without them waiting would never end.
+    // Due ones complete here rather than waiting for a tick that may not be running
+    uint32_t flags = spin_lock_irqsave(&syscall_ring_lock);
+    syscall_ring_expire(state, ktime_ns());
+    uint32_t ready = ring->cq_tail - ring->cq_head;
+    if (min_complete > ready && state->pending > 0)
+    {
+        state->waiter = task;
+        state->wait_for = min_complete;
+        state->waiter_result = submitted;
+        task->state = TASK_STATE_BLOCKED;
+        *blocked = true;
+    }
+    spin_unlock_irqrestore(&syscall_ring_lock, flags);
+
+    return submitted;
+}
+
+static void syscall_ring_tick_process(struct syscall_ring_state *state, uint64_t now)
+{
+    struct syscall_ring *ring = state->ring;
+    syscall_ring_expire(state, now);
+
+    struct task *waiter = state->waiter;
+    if (waiter && (ring->cq_tail - ring->cq_head >= state->wait_for || state->pending == 0))
+    {
+        state->waiter = 0;
+        waiter->registers.eax = state->waiter_result;
+        sched_enqueue(waiter);
+    }
+}
+
+void syscall_ring_tick()
+{
+    uint64_t now = ktime_ns();
+    uint32_t flags = spin_lock_irqsave(&syscall_ring_lock);
+    for (int i = 0; i < VIOS_MAX_PROCESSES; i++)
+    {
+        struct process *process = process_get(i);
+        if (process && process->ring.ring && process->ring.pending > 0)
+        {
+            syscall_ring_tick_process(&process->ring, now);
+        }
+    }
+    spin_unlock_irqrestore(&syscall_ring_lock, flags);
+}
+
+bool syscall_ring_timeouts_armed()
+{
+    return syscall_ring_armed > 0;
+}
+
+bool syscall_ring_poll()
+{
+    if (ktime_tick_enabled() || !syscall_ring_timeouts_armed())
+    {
+        return false;
+    }
+
+    syscall_ring_tick();
+    return true;
+}
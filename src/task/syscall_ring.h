@@ -0,0 +1,93 @@
+#ifndef SYSCALL_RING_H
+#define SYSCALL_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// Not an isr80h command, completes after args[0] milliseconds without blocking the submitter
+#define SYSCALL_RING_OP_TIMEOUT 0xFFFF
+
+#define SYSCALL_RING_MAX_ARGS 7
+
+struct process;
+struct task;
+
+/**
+ * One queued system call. args fill EBX, ECX, EDX, ESI and EDI for register based
+ * commands and double as the user stack for the ones that read task_get_stack_item.
+ */
+struct syscall_ring_sqe
+{
+    uint32_t command;
+    uint32_t args[SYSCALL_RING_MAX_ARGS];
+    uint32_t user_data;
+};
+
+struct syscall_ring_cqe
+{
+    uint32_t user_data;
+    int32_t result;
+};
+
+/**
+ * Lives in process memory and is shared with the kernel. The process owns
+ * sq_tail and cq_head, the kernel owns sq_head and cq_tail. Indices are free running.
+ */
+struct syscall_ring
+{
+    volatile uint32_t sq_head;
+    volatile uint32_t sq_tail;
+    volatile uint32_t cq_head;
+    volatile uint32_t cq_tail;
+    struct syscall_ring_sqe sq[VIOS_SYSCALL_RING_ENTRIES];
+    struct syscall_ring_cqe cq[VIOS_SYSCALL_RING_ENTRIES];
+};
+
+struct syscall_ring_timeout
+{
+    bool used;
+    uint64_t deadline_ns;
+    uint32_t user_data;
+};
+
+// Kernel side bookkeeping kept in struct process
+struct syscall_ring_state
+{
+    struct syscall_ring *ring;
+
+    // Armed timeouts, each one holds a completion slot until it fires
+    struct syscall_ring_timeout timeouts[VIOS_SYSCALL_RING_ENTRIES];
+    int pending;
+
+    // The task blocked in syscall_ring_enter and how many completions it wants
+    struct task *waiter;
+    uint32_t wait_for;
+    int waiter_result;
+};
+
+void syscall_ring_init();
+int syscall_ring_setup(struct process *process, void *ring);
+void syscall_ring_release(struct process *process);
+
+/**
+ * Runs up to to_submit queued calls, returns how many were consumed.
+ * Timeouts that are already due complete first. Returns 1 in *blocked when the task has to
+ * wait for min_complete completions, the caller then schedules away and the timer tick
+ * (or syscall_ring_poll while idle) resumes it with the submit count.
+ */
+int syscall_ring_enter(struct process *process, uint32_t to_submit, uint32_t min_complete, bool *blocked);
+
+// Retires expired timeouts, called from the timer interrupt
+void syscall_ring_tick();
+
+// True while any process has a timeout waiting, lets the timer skip syscall_ring_tick
+bool syscall_ring_timeouts_armed();
+
+/**
+ * Stands in for the tick while it is off: retires expired timeouts when any are armed.
+ * Returns false when there was nothing to poll, the idle loop then halts instead.
+ */
+bool syscall_ring_poll();
+
+#endif
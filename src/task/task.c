@@ -9,6 +9,12 @@
 #include "memory/paging/paging.h"
 #include "loader/formats/elfloader.h"
 #include "idt/idt.h"
+#include "idt/softirq.h"
+#include "sched.h"
+#include "syscall_ring.h"
+#include "sync/spinlock.h"
+#include "sync/futex.h"
+#include "sync/waitqueue.h"
 
 // The current task that is running
 struct task *current_task = 0;
@@ -17,8 +23,16 @@ struct task *current_task = 0;
 struct task *task_tail = 0;
 struct task *task_head = 0;
 
+// Protects task_head/task_tail and the next/prev links
+static struct spinlock task_list_lock;
+
 int task_init(struct task *task, struct process *process);
 
+void task_list_init()
+{
+    spinlock_init(&task_list_lock, "task_list");
+}
+
 struct task *task_current()
 {
     return current_task;
@@ -40,17 +54,22 @@ struct task *task_new(struct process *process)
         goto out;
     }
 
+    uint32_t flags = spin_lock_irqsave(&task_list_lock);
     if (task_head == 0)
     {
         task_head = task;
         task_tail = task;
         current_task = task;
-        goto out;
     }
+    else
+    {
+        task_tail->next = task;
+        task->prev = task_tail;
+        task_tail = task;
+    }
+    spin_unlock_irqrestore(&task_list_lock, flags);
 
-    task_tail->next = task;
-    task->prev = task_tail;
-    task_tail = task;
+    sched_enqueue(task);
 
 out:
     if (ISERR(res))
@@ -62,7 +81,7 @@ out:
     return task;
 }
 
-struct task *task_get_next()
+static struct task *task_get_next_locked()
 {
     if (!current_task->next)
     {
@@ -72,13 +91,27 @@ struct task *task_get_next()
     return current_task->next;
 }
 
+struct task *task_get_next()
+{
+    uint32_t flags = spin_lock_irqsave(&task_list_lock);
+    struct task *next = task_get_next_locked();
+    spin_unlock_irqrestore(&task_list_lock, flags);
+    return next;
+}
+
 static void task_list_remove(struct task *task)
 {
+    uint32_t flags = spin_lock_irqsave(&task_list_lock);
     if (task->prev)
     {
         task->prev->next = task->next;
     }
 
+    if (task->next)
+    {
+        task->next->prev = task->prev;
+    }
+
     if (task == task_head)
     {
         task_head = task->next;
@@ -91,14 +124,19 @@ static void task_list_remove(struct task *task)
 
     if (task == current_task)
     {
-        current_task = task_get_next();
+        current_task = task_get_next_locked();
     }
+    spin_unlock_irqrestore(&task_list_lock, flags);
 }
 
 int task_free(struct task *task)
 {
     paging_free_4gb(task->page_directory);
     task_list_remove(task);
+    sched_remove(task);
+    fpu_task_free(task);
+    futex_task_free(task);
+    wait_queue_remove(task);
 
     // Finally free the task data
     kfree(task);
@@ -107,10 +145,33 @@ int task_free(struct task *task)
 
 void task_next()
 {
-    struct task *next_task = task_get_next();
-    if (!next_task)
+    struct task *next_task = sched_pick_next();
+    while (!next_task)
     {
-        panic("No more tasks!\n");
+        // Nothing else is runnable, keep running the current task if it still can
+        if (current_task && current_task->state == TASK_STATE_RUNNING)
+        {
+            next_task = current_task;
+            break;
+        }
+
+        if (!task_head)
+        {
+            panic("No more tasks!\n");
+        }
+
+        // Every task is blocked. Sleep until an interrupt's softirq work wakes one,
+        // on the kernel stack of whatever call got us here. Work a nested drain left
+        // queued (a key for a blocked console read, say) runs first, no interrupt would run it
+        if (softirq_pending())
+        {
+            softirq_run();
+        }
+        else if (!syscall_ring_poll())
+        {
+            wait_for_interrupt();
+        }
+        next_task = sched_pick_next();
     }
 
     task_switch(next_task);
@@ -119,7 +180,19 @@ void task_next()
 
 int task_switch(struct task *task)
 {
+    // A task that is switched away from while still running goes back on a run queue
+    if (current_task && current_task != task && current_task->state == TASK_STATE_RUNNING)
+    {
+        sched_enqueue(current_task);
+    }
+
+    if (current_task != task)
+    {
+        fpu_task_switched(task);
+    }
+
     current_task = task;
+    task->state = TASK_STATE_RUNNING;
     paging_switch(task->page_directory);
     return 0;
 }
@@ -175,6 +248,71 @@ out_free:
 out:
     return res;
 }
+// Walks the task's page tables one page at a time, user memory isn't always contiguous
+static int task_copy(struct task *task, void *kernel_buf, uint32_t virtual, int size, bool to_task)
+{
+    uint32_t required = PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL;
+    if (to_task)
+    {
+        required |= PAGING_IS_WRITEABLE;
+    }
+
+    if (size < 0 || virtual + (uint32_t)size < virtual)
+    {
+        return -EINVARG;
+    }
+
+    char *buf = kernel_buf;
+    while (size > 0)
+    {
+        uint32_t offset = virtual % PAGING_PAGE_SIZE;
+        uint32_t entry = paging_get(task->page_directory->directory_entry, (void *)(virtual - offset));
+        if ((entry & required) != required)
+        {
+            return -EINVARG;
+        }
+
+        int chunk = PAGING_PAGE_SIZE - offset;
+        if (chunk > size)
+        {
+            chunk = size;
+        }
+
+        char *phys = (char *)((entry & 0xfffff000) + offset);
+        if (to_task)
+        {
+            memcpy(phys, buf, chunk);
+        }
+        else
+        {
+            memcpy(buf, phys, chunk);
+        }
+
+        buf += chunk;
+        virtual += chunk;
+        size -= chunk;
+    }
+
+    return 0;
+}
+
+int copy_from_task(struct task *task, void *dst, const void *virtual, int size)
+{
+    return task_copy(task, dst, (uint32_t)virtual, size, false);
+}
+
+int copy_to_task(struct task *task, void *virtual, const void *src, int size)
+{
+    return task_copy(task, (void *)src, (uint32_t)virtual, size, true);
+}
+
+void task_restart_syscall(struct task *task)
+{
+    // Back up over the two byte "int 0x80" so the call runs again when the task is resumed.
+    // EAX still holds the command number, wakers never write a return value into it.
+    task->registers.ip -= 2;
+}
+
 void task_current_save_state(struct interrupt_frame *frame)
 {
     if (!task_current())
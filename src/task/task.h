@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "memory/paging/paging.h"
+#include "fpu.h"
 
 struct interrupt_frame;
 struct registers
@@ -22,7 +23,12 @@ struct registers
     uint32_t ss;
 };
 
+#define TASK_STATE_READY 0
+#define TASK_STATE_RUNNING 1
+#define TASK_STATE_BLOCKED 2
+
 struct process;
+struct wait_queue;
 struct task
 {
     /**
@@ -30,12 +36,32 @@ struct task
      */
     struct paging_4gb_chunk *page_directory;
 
+    // x87/SSE state, only saved and restored lazily on #NM
+    struct fpu_state fpu;
+
+    // Set once the task has executed its first FPU instruction
+    bool fpu_used;
+
     // The registers of the task when the task is not running
     struct registers registers;
 
     // The process of the task
     struct process *process;
 
+    // TASK_STATE_READY, TASK_STATE_RUNNING or TASK_STATE_BLOCKED
+    int state;
+
+    // The CPU whose run queue the task was last placed on
+    int cpu;
+
+    // Physical address the task is blocked on in futex_wait, zero when not waiting
+    uint32_t futex_key;
+    struct task *futex_next;
+
+    // The wait queue the task is blocked on, see sync/waitqueue.c
+    struct wait_queue *wait_queue;
+    struct task *wait_next;
+
     // The next task in the linked list
     struct task *next;
 
@@ -43,6 +69,7 @@ struct task
     struct task *prev;
 };
 
+void task_list_init();
 struct task *task_new(struct process *process);
 struct task *task_current();
 struct task *task_get_next();
@@ -60,6 +87,9 @@ void user_registers();
 
 void task_current_save_state(struct interrupt_frame *frame);
 int copy_string_from_task(struct task *task, void *virtual, void *phys, int max);
+int copy_from_task(struct task *task, void *dst, const void *virtual, int size);
+int copy_to_task(struct task *task, void *virtual, const void *src, int size);
+void task_restart_syscall(struct task *task);
 void *task_get_stack_item(struct task *task, int index);
 void *task_virtual_address_to_physical(struct task *task, void *virtual_address);
 void task_next();
@@ -0,0 +1,309 @@
+#include "ktime.h"
+#include "cpu/cpu.h"
+#include "idt/idt.h"
+#include "idt/softirq.h"
+#include "irq/irq.h"
+#include "irq/apic.h"
+#include "io/io.h"
+#include "math/div64.h"
+#include "debug/simple_serial.h"
+#include "string/string.h"
+#include "vclock.h"
+#include "task/syscall_ring.h"
+
+#define KTIME_PIT_CHANNEL0_DATA 0x40
+#define KTIME_PIT_CHANNEL2_DATA 0x42
+#define KTIME_PIT_COMMAND 0x43
+#define KTIME_PIT_CHANNEL2_GATE 0x61
+
+#define KTIME_PIT_TIMER_INTERRUPT IRQ_VECTOR(IRQ_TIMER)
+
+// Channel 2 one-shot window used to calibrate the TSC, about 10ms
+#define KTIME_CALIBRATE_MS 10
+#define KTIME_CALIBRATE_ROUNDS 3
+
+static bool ktime_has_tsc = false;
+static uint64_t ktime_tsc_base = 0;
+static uint32_t ktime_tsc_hz = 0;
+
+// ns = (tsc * mult) >> shift
+static uint32_t ktime_mult = 0;
+static uint32_t ktime_shift = 0;
+
+static volatile uint32_t ktime_tick_count = 0;
+
+// The LAPIC timer replaces PIT channel 0 as the tick when the APICs are in use
+static bool ktime_lapic_tick = false;
+
+// Retires syscall ring timeouts outside the timer interrupt
+static struct softirq_work ktime_ring_work;
+
+// Set once ktime_enable_tick has unmasked the tick source
+static bool ktime_tick_running = false;
+
+uint64_t ktime_read_tsc()
+{
+    if (!ktime_has_tsc)
+    {
+        return 0;
+    }
+
+    uint64_t tsc;
+    __asm__ __volatile__("rdtsc" : "=A"(tsc));
+    return tsc;
+}
+
+// Runs PIT channel 2 in mode 0 for count ticks and returns once OUT goes high
+static void ktime_pit_oneshot(uint16_t count)
+{
+    // Gate low and speaker off while loading the count
+    uint8_t gate = insb(KTIME_PIT_CHANNEL2_GATE) & ~0x03;
+    outb(KTIME_PIT_CHANNEL2_GATE, gate);
+
+    outb(KTIME_PIT_COMMAND, 0xB0); // Channel 2, lobyte/hibyte, mode 0, binary
+    outb(KTIME_PIT_CHANNEL2_DATA, count & 0xFF);
+    outb(KTIME_PIT_CHANNEL2_DATA, (count >> 8) & 0xFF);
+
+    // Raising the gate starts the countdown
+    outb(KTIME_PIT_CHANNEL2_GATE, gate | 0x01);
+    while (!(insb(KTIME_PIT_CHANNEL2_GATE) & 0x20))
+    {
+    }
+}
+
+static uint32_t ktime_calibrate_tsc()
+{
+    uint16_t count = (KTIME_PIT_FREQUENCY * KTIME_CALIBRATE_MS) / 1000;
+    uint64_t best = 0;
+
+    for (int i = 0; i < KTIME_CALIBRATE_ROUNDS; i++)
+    {
+        uint64_t start = ktime_read_tsc();
+        ktime_pit_oneshot(count);
+        uint64_t delta = ktime_read_tsc() - start;
+
+        // Anything that delays us only makes a round longer, keep the shortest
+        if (best == 0 || delta < best)
+        {
+            best = delta;
+        }
+    }
+
+    return (uint32_t)div_u64(best * 1000, KTIME_CALIBRATE_MS);
+}
+
+static void ktime_compute_scale(uint32_t hz)
+{
+    // Largest shift whose multiplier still fits in 32 bits keeps the most precision
+    uint32_t shift = 32;
+    uint64_t mult = div_u64(1000000000ULL << shift, hz);
+    while (mult > 0xFFFFFFFFULL && shift > 0)
+    {
+        shift--;
+        mult = div_u64(1000000000ULL << shift, hz);
+    }
+
+    ktime_mult = (uint32_t)mult;
+    ktime_shift = shift;
+}
+
+void ktime_get_tsc_scale(uint32_t *mult, uint32_t *shift, uint64_t *base_tsc)
+{
+    *mult = ktime_mult;
+    *shift = ktime_shift;
+    *base_tsc = ktime_tsc_base;
+}
+
+uint64_t ktime_tsc_to_ns(uint64_t tsc)
+{
+    // 64x32 multiply split in halves so the intermediate doesn't overflow
+    uint64_t low = (uint64_t)(uint32_t)tsc * ktime_mult;
+    uint64_t high = (uint64_t)(uint32_t)(tsc >> 32) * ktime_mult;
+    return (low >> ktime_shift) + (high << (32 - ktime_shift));
+}
+
+// The tick count and the boot allocated vclock page are safe to touch from the top half
+static int ktime_tick_interrupt_handler(struct interrupt_frame *frame)
+{
+    ktime_tick_count++;
+    vclock_tick(ktime_tick_count);
+    if (syscall_ring_timeouts_armed())
+    {
+        softirq_raise(&ktime_ring_work);
+    }
+    return IDT_IRQ_HANDLED;
+}
+
+// Syscall ring timeouts complete into process memory, so they need the kernel page tables
+static void ktime_ring_timeouts(void *data)
+{
+    syscall_ring_tick();
+}
+
+// Counts LAPIC timer decrements across the same channel 2 window used for the TSC
+static uint32_t ktime_calibrate_lapic_timer()
+{
+    uint16_t count = (KTIME_PIT_FREQUENCY * KTIME_CALIBRATE_MS) / 1000;
+    uint32_t best = 0;
+
+    for (int i = 0; i < KTIME_CALIBRATE_ROUNDS; i++)
+    {
+        apic_timer_oneshot(0xFFFFFFFF);
+        ktime_pit_oneshot(count);
+        uint32_t elapsed = 0xFFFFFFFF - apic_timer_current();
+
+        if (best == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    apic_timer_oneshot(0);
+    return (uint32_t)div_u64((uint64_t)best * 1000, KTIME_CALIBRATE_MS * KTIME_TICK_HZ);
+}
+
+static bool ktime_init_lapic_timer()
+{
+    if (!irq_using_apic())
+    {
+        return false;
+    }
+
+    uint32_t per_tick = ktime_calibrate_lapic_timer();
+    if (per_tick == 0)
+    {
+        return false;
+    }
+
+    // Programmed masked, ktime_enable_tick opens it like the PIT line
+    apic_timer_periodic(per_tick, APIC_TIMER_VECTOR);
+    apic_timer_set_masked(true);
+    idt_register_fast_interrupt_callback(APIC_TIMER_VECTOR, ktime_tick_interrupt_handler);
+    simple_serial_puts("  LAPIC timer is the tick source\n");
+    return true;
+}
+
+static void ktime_init_pit_timer()
+{
+    uint16_t divisor = KTIME_PIT_FREQUENCY / KTIME_TICK_HZ;
+    outb(KTIME_PIT_COMMAND, 0x36); // Channel 0, lobyte/hibyte, mode 3
+    outb(KTIME_PIT_CHANNEL0_DATA, divisor & 0xFF);
+    outb(KTIME_PIT_CHANNEL0_DATA, (divisor >> 8) & 0xFF);
+
+    softirq_work_init(&ktime_ring_work, ktime_ring_timeouts, 0);
+    idt_register_fast_interrupt_callback(KTIME_PIT_TIMER_INTERRUPT, ktime_tick_interrupt_handler);
+}
+
+void ktime_init()
+{
+    ktime_init_pit_timer();
+    ktime_lapic_tick = ktime_init_lapic_timer();
+
+    if (!cpu_get_features()->tsc)
+    {
+        simple_serial_puts("  No TSC, falling back to PIT ticks\n");
+        return;
+    }
+
+    ktime_has_tsc = true;
+    ktime_tsc_hz = ktime_calibrate_tsc();
+    if (ktime_tsc_hz == 0)
+    {
+        ktime_has_tsc = false;
+        return;
+    }
+
+    ktime_compute_scale(ktime_tsc_hz);
+    ktime_tsc_base = ktime_read_tsc();
+
+    char buf[16];
+    int_to_str((int)(ktime_tsc_hz / 1000), buf);
+    simple_serial_puts("  TSC calibrated at ");
+    simple_serial_puts(buf);
+    simple_serial_puts(" kHz\n");
+}
+
+uint64_t ktime_ns()
+{
+    if (!ktime_has_tsc)
+    {
+        return (uint64_t)ktime_tick_count * (KTIME_NS_PER_MS * 1000 / KTIME_TICK_HZ);
+    }
+
+    return ktime_tsc_to_ns(ktime_read_tsc() - ktime_tsc_base);
+}
+
+uint64_t ktime_us()
+{
+    return div_u64(ktime_ns(), KTIME_NS_PER_US);
+}
+
+uint32_t ktime_ms()
+{
+    return (uint32_t)div_u64(ktime_ns(), KTIME_NS_PER_MS);
+}
+
+bool ktime_tsc_available()
+{
+    return ktime_has_tsc;
+}
+
+uint32_t ktime_tsc_khz()
+{
+    return ktime_tsc_hz / 1000;
+}
+
+uint32_t ktime_ticks()
+{
+    return ktime_tick_count;
+}
+
+void ktime_delay_us(uint32_t us)
+{
+    if (ktime_has_tsc)
+    {
+        uint64_t end = ktime_ns() + (uint64_t)us * KTIME_NS_PER_US;
+        while (ktime_ns() < end)
+        {
+            __asm__ __volatile__("pause");
+        }
+        return;
+    }
+
+    // Without a TSC poll PIT channel 2, its 16-bit counter covers at most ~54ms per shot
+    while (us > 0)
+    {
+        uint32_t chunk = us > 50000 ? 50000 : us;
+        uint32_t count = (uint32_t)div_u64((uint64_t)chunk * KTIME_PIT_FREQUENCY, 1000000);
+        ktime_pit_oneshot(count ? count : 1);
+        us -= chunk;
+    }
+}
+
+void ktime_delay_ms(uint32_t ms)
+{
+    while (ms > 0)
+    {
+        // Stay well below the 32-bit microsecond limit
+        uint32_t chunk = ms > 1000000 ? 1000000 : ms;
+        ktime_delay_us(chunk * 1000);
+        ms -= chunk;
+    }
+}
+
+void ktime_enable_tick()
+{
+    ktime_tick_running = true;
+    if (ktime_lapic_tick)
+    {
+        apic_timer_set_masked(false);
+        return;
+    }
+
+    irq_unmask(IRQ_TIMER);
+}
+
+bool ktime_tick_enabled()
+{
+    return ktime_tick_running;
+}
@@ -0,0 +1,48 @@
+#ifndef KTIME_H
+#define KTIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define KTIME_PIT_FREQUENCY 1193182
+#define KTIME_TICK_HZ 1000
+
+#define KTIME_NS_PER_US 1000
+#define KTIME_NS_PER_MS 1000000
+
+/**
+ * Monotonic clocksource. Uses the TSC calibrated against PIT channel 2 at boot,
+ * or the 1kHz tick count when the CPU has no TSC. The tick comes from the LAPIC timer
+ * when the APICs are in use and from PIT channel 0 otherwise.
+ */
+void ktime_init();
+
+uint64_t ktime_ns();
+uint64_t ktime_us();
+uint32_t ktime_ms();
+
+// Raw TSC read, zero when unavailable
+uint64_t ktime_read_tsc();
+bool ktime_tsc_available();
+uint32_t ktime_tsc_khz();
+
+// Scale used by ktime_ns(), for publishing the clock to user space
+void ktime_get_tsc_scale(uint32_t *mult, uint32_t *shift, uint64_t *base_tsc);
+
+// Converts a TSC delta to nanoseconds
+uint64_t ktime_tsc_to_ns(uint64_t tsc);
+
+// Number of timer interrupts since ktime_init
+uint32_t ktime_ticks();
+
+// Unmasks the tick, the LAPIC timer when the APICs are in use or PIT channel 0 otherwise
+void ktime_enable_tick();
+
+// False until ktime_enable_tick, nothing then runs on timer interrupts
+bool ktime_tick_enabled();
+
+// Busy waits
+void ktime_delay_us(uint32_t us);
+void ktime_delay_ms(uint32_t ms);
+
+#endif
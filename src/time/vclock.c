@@ -0,0 +1,88 @@
+#include "vclock.h"
+#include "ktime.h"
+#include "config.h"
+#include "status.h"
+#include "sync/spinlock.h"
+#include "memory/heap/kheap.h"
+#include "memory/paging/paging.h"
+#include "panic/panic.h"
+
+static struct vclock_page *vclock_page = 0;
+
+// Serializes writers, the timer IRQ and graphics_present both update the page
+static struct spinlock vclock_lock;
+
+static uint32_t vclock_write_begin()
+{
+    uint32_t flags = spin_lock_irqsave(&vclock_lock);
+    vclock_page->seq++;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return flags;
+}
+
+static void vclock_write_end(uint32_t flags)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    vclock_page->seq++;
+    spin_unlock_irqrestore(&vclock_lock, flags);
+}
+
+void vclock_init()
+{
+    // Heap blocks are page sized and page aligned, so this is exactly one mappable page
+    vclock_page = kzalloc(PAGING_PAGE_SIZE);
+    if (!vclock_page)
+    {
+        panic("Failed to allocate the vclock page\n");
+    }
+
+    spinlock_init(&vclock_lock, "vclock");
+
+    uint32_t flags = vclock_write_begin();
+    if (ktime_tsc_available())
+    {
+        ktime_get_tsc_scale(&vclock_page->mult, &vclock_page->shift, &vclock_page->base_tsc);
+        vclock_page->flags = VCLOCK_FLAG_TSC;
+    }
+    vclock_page->coarse_ns = ktime_ns();
+    vclock_page->ticks = ktime_ticks();
+    vclock_page->tick_hz = KTIME_TICK_HZ;
+    vclock_write_end(flags);
+}
+
+int vclock_map(struct paging_4gb_chunk *directory)
+{
+    if (!vclock_page)
+    {
+        return -EIO;
+    }
+
+    // Not writeable, user code can only read it
+    return paging_map(directory, (void *)VIOS_VCLOCK_VIRTUAL_ADDRESS, vclock_page, PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL);
+}
+
+void vclock_tick(uint32_t ticks)
+{
+    if (!vclock_page)
+    {
+        return;
+    }
+
+    uint32_t flags = vclock_write_begin();
+    vclock_page->ticks = ticks;
+    vclock_page->coarse_ns = ktime_ns();
+    vclock_write_end(flags);
+}
+
+void vclock_frame_presented()
+{
+    if (!vclock_page)
+    {
+        return;
+    }
+
+    uint32_t flags = vclock_write_begin();
+    vclock_page->frame_count++;
+    vclock_page->coarse_ns = ktime_ns();
+    vclock_write_end(flags);
+}
@@ -0,0 +1,40 @@
+#ifndef VCLOCK_H
+#define VCLOCK_H
+
+#include <stdint.h>
+
+#define VCLOCK_FLAG_TSC 0x01
+
+struct paging_4gb_chunk;
+
+/**
+ * Read-only page mapped into every process at VIOS_VCLOCK_VIRTUAL_ADDRESS.
+ * Readers retry while seq is odd or changed during the read (seqlock).
+ * The layout is shared with assets/programs/stdlib/src/clock.h.
+ */
+struct vclock_page
+{
+    volatile uint32_t seq;
+    uint32_t flags;
+
+    // ns = ((rdtsc - base_tsc) * mult) >> shift, valid when VCLOCK_FLAG_TSC is set
+    uint32_t mult;
+    uint32_t shift;
+    uint64_t base_tsc;
+
+    // Monotonic ns at the last update, the only time source without a TSC
+    uint64_t coarse_ns;
+
+    uint32_t ticks;
+    uint32_t tick_hz;
+
+    // Frames presented through graphics_present
+    uint32_t frame_count;
+};
+
+void vclock_init();
+int vclock_map(struct paging_4gb_chunk *directory);
+void vclock_tick(uint32_t ticks);
+void vclock_frame_presented();
+
+#endif